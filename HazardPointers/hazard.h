@@ -0,0 +1,2723 @@
+/******************************************************************************/
+/*!
+\file   hazard.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief  
+    This file contains the memory reclamation building blocks shared by
+	every container in this sample: the hazard pointer domain, the
+	reclamation policies built on it, and the memory bank. None of them
+	know what they protect; each retired pointer carries its own
+	type-erased reclaim function.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include <atomic>    // std::atomic
+#include <thread>    // std::thread
+#include <vector>    // std::vector
+#include <mutex>     // std::mutex
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <cstddef>   // offsetof
+#include <utility>   // std::pair
+#include <new>       // std::bad_alloc
+#include <stdexcept> // std::length_error
+#include <unordered_map> // std::unordered_map
+#include <unordered_set> // std::unordered_set
+#include <algorithm> // std::sort, std::binary_search, std::unique
+#include <type_traits> // std::is_trivially_copyable
+#include <chrono>    // std::chrono::steady_clock
+
+#include "trace.h"
+
+/**************************************************************************/
+/*!
+  \class ThreadSlots
+  \brief  
+    Per-thread storage of records that belong to a specific owner object
+	(such as one MemoryBank's cache for this thread). Lets each thread
+	find its own record for an owner without any locking, and hands the
+	record back to its owner when the thread exits.
+
+    Non-Core Operations Include:
+
+    -Registers a new owner and returns its unique id.
+	-Unregisters an owner so no more exit callbacks run for it.
+	-Finds the calling thread's record for an owner.
+	-Adds a record for an owner to the calling thread.
+	-Checks whether the calling thread is already shutting down.
+
+*/
+/**************************************************************************/
+class ThreadSlots
+{
+	/*!
+	  \struct Entry
+	  \brief
+	    A single record and the callback that hands it back on thread exit.
+	*/
+	struct Entry
+	{
+		void* record;                       // The owner's record for this thread
+		void (*onExit)(void*, void*);       // Called as onExit(owner, record)
+		void* owner;                        // The object the record belongs to
+	};
+
+	std::unordered_map<std::uint64_t, Entry> entries; // This thread's records by owner id
+	std::uint64_t lastId;                             // Owner id of the most recent lookup
+	void* lastRecord;                                 // Record of the most recent lookup
+	std::size_t pruneAt;                              // # of entries at which to drop dead owners
+	std::uint64_t prunedThrough;                      // Value of unregistered at the last prune
+
+	inline static std::atomic<std::uint64_t> nextId{1};        // Source of unique owner ids
+	inline static std::atomic<std::uint64_t> unregistered{0};  // # of owners destroyed so far
+	inline static std::mutex liveMutex;                         // Guards liveOwners; cold paths only
+	inline static std::unordered_set<std::uint64_t> liveOwners; // Owners that have not been destroyed
+	inline static thread_local bool exiting = false;            // Set once local has been destroyed
+	static thread_local ThreadSlots local;                      // This thread's records (defined below,
+	                                                            // as the class must be complete first)
+
+	inline static const std::size_t pruneMin = 16; // Fewest entries worth pruning
+
+	/*!******************************************************************
+      \brief
+        Drops the entries of owners destroyed since the last prune, so a
+		thread that outlives many short-lived owners keeps a map no more
+		than twice the size of its live ones. Skips the lock entirely if
+		no owner has been destroyed since.
+    ********************************************************************/
+	void Prune()
+	{
+		std::uint64_t seen = unregistered.load();
+		if(seen != prunedThrough)
+		{
+			std::lock_guard<std::mutex> lock(liveMutex);
+			for(auto entry = entries.begin(); entry != entries.end();)
+			{
+				if(liveOwners.count(entry->first))
+					++entry;
+				else
+					entry = entries.erase(entry);
+			}
+			prunedThrough = seen;
+
+			if(entries.find(lastId) == entries.end())
+			{
+				lastId = 0;
+				lastRecord = nullptr;
+			}
+		}
+
+		pruneAt = std::max(pruneMin, 2 * entries.size());
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ThreadSlots class.
+    ********************************************************************/
+	ThreadSlots() : entries(), lastId(0), lastRecord(nullptr), pruneAt(pruneMin), prunedThrough(0)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the ThreadSlots class. Hands every record back to
+		its owner, skipping owners that have already been destroyed.
+    ********************************************************************/
+	~ThreadSlots()
+	{
+		exiting = true;
+
+		std::lock_guard<std::mutex> lock(liveMutex);
+		for(auto& entry : entries)
+			if(liveOwners.count(entry.first))
+				entry.second.onExit(entry.second.owner, entry.second.record);
+	}
+
+	/*!******************************************************************
+      \brief
+        Registers a new owner and returns its unique id.
+
+	  \return
+	  	The id to use in all later calls for this owner.
+    ********************************************************************/
+	static std::uint64_t Register()
+	{
+		std::uint64_t id = nextId.fetch_add(1);
+
+		std::lock_guard<std::mutex> lock(liveMutex);
+		liveOwners.insert(id);
+		return id;
+	}
+
+	/*!******************************************************************
+      \brief
+        Unregisters an owner. Once this returns, no exit callback will
+		run for it, so the owner may safely destroy its records.
+
+	  \param id
+	  	The id of the owner being destroyed.
+    ********************************************************************/
+	static void Unregister(std::uint64_t id)
+	{
+		std::lock_guard<std::mutex> lock(liveMutex);
+		liveOwners.erase(id);
+		unregistered.fetch_add(1);
+	}
+
+	/*!******************************************************************
+      \brief
+        Finds the calling thread's record for an owner.
+
+	  \param id
+	  	The id of the owner.
+
+	  \return
+	  	The record, or nullptr if this thread has none yet.
+    ********************************************************************/
+	static void* Find(std::uint64_t id)
+	{
+		if(exiting)
+			return nullptr;
+
+		if(local.lastId == id)
+			return local.lastRecord;
+
+		auto found = local.entries.find(id);
+		if(found == local.entries.end())
+			return nullptr;
+
+		local.lastId = id;
+		local.lastRecord = found->second.record;
+		return local.lastRecord;
+	}
+
+	/*!******************************************************************
+      \brief
+        Adds a record for an owner to the calling thread.
+
+	  \param id
+	  	The id of the owner.
+
+	  \param record
+	  	The record to keep for this thread.
+
+	  \param onExit
+	  	Called as onExit(owner, record) when this thread exits while
+		the owner is still alive.
+
+	  \param owner
+	  	The owner of the record.
+
+	  Every time the map doubles, first drops the entries of owners that
+	  have been destroyed.
+    ********************************************************************/
+	static void Add(std::uint64_t id, void* record, void (*onExit)(void*, void*), void* owner)
+	{
+		if(local.entries.size() >= local.pruneAt)
+			local.Prune();
+
+		local.entries[id] = Entry{ record, onExit, owner };
+		local.lastId = id;
+		local.lastRecord = record;
+	}
+
+	/*!******************************************************************
+      \brief
+        Checks whether the calling thread is already shutting down, in
+		which case no new records may be added.
+
+	  \return
+	  	Whether this thread's records have already been handed back.
+    ********************************************************************/
+	static bool Exiting()
+	{
+		return exiting;
+	}
+};
+
+inline thread_local ThreadSlots ThreadSlots::local;
+
+/*!******************************************************************
+  \brief
+    Statistics are opt-in: build with LFSV_STATS defined to collect them.
+	Without it, every LFSV_STAT() statement compiles to nothing and
+	LFSV::Stats() returns an empty snapshot.
+********************************************************************/
+#ifdef LFSV_STATS
+#define LFSV_STAT(statement) statement
+#else
+#define LFSV_STAT(statement)
+#endif
+
+/*!
+  \struct BankStats
+  \brief
+    A snapshot of one MemoryBank's occupancy and shared-path traffic.
+*/
+struct BankStats
+{
+	std::size_t capacity = 0;       // # of slots in every slab allocated so far
+	std::size_t inUse = 0;          // # of slots handed out and not yet returned
+	std::uint64_t refills = 0;      // # of batches taken from the global stack (or a new slab)
+	std::uint64_t drains = 0;       // # of batches pushed back onto the global stack
+	std::uint64_t sharedNanos = 0;  // Time spent refilling and draining, in ns
+};
+
+/*!
+  \struct ReclaimStats
+  \brief
+    A snapshot of one reclamation policy's retired pointers and scans.
+*/
+struct ReclaimStats
+{
+	std::uint64_t retired = 0;      // # of pointers retired
+	std::uint64_t reclaimed = 0;    // # of pointers reclaimed
+	std::uint64_t scans = 0;        // # of scans (or epoch collections) run
+	std::uint64_t scanNanos = 0;    // Time spent scanning, in ns
+	std::size_t hazards = 0;        // # of live hazards seen by the latest scan (epochs:
+	                                // # of threads currently inside a critical section)
+	std::size_t maxRetired = 0;     // Longest retired list any thread has held
+};
+
+/*!******************************************************************
+  \brief
+    Adds to a counter that only one thread ever writes. Skips the locked
+	read-modify-write, as there is nothing to race with.
+
+  \param counter
+	The counter to add to.
+
+  \param amount
+	The amount to add.
+********************************************************************/
+inline void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**************************************************************************/
+/*!
+  \class StatBlocks
+  \brief  
+    Per-thread blocks of Counters, each on its own cache line(s), so
+	threads never contend while counting. A block left behind by an
+	exited thread is handed to the next new thread and keeps its counts,
+	so summing every block always gives the totals.
+
+    Non-Core Operations Include:
+
+    -Returns the calling thread's block, claiming one if needed.
+	-Visits every block, for aggregation.
+
+*/
+/**************************************************************************/
+template <typename Counters>
+class StatBlocks
+{
+	/*!
+	  \struct Block
+	  \brief
+	    One thread's counters, padded out to whole cache lines.
+	*/
+	struct alignas(64) Block : Counters
+	{
+		std::atomic<bool> active{false}; // Whether a thread currently owns this block
+		Block* next = nullptr;           // Pointer to the next block in the list
+	};
+
+	std::atomic<Block*> blocks; // Every block created so far
+	std::uint64_t id;           // This set's id within ThreadSlots
+
+	/*!******************************************************************
+      \brief
+        Hands a block back when the owning thread exits.
+
+	  \param owner
+	  	Unused.
+
+	  \param record
+	  	The block.
+    ********************************************************************/
+	static void OnThreadExit(void*, void* record)
+	{
+		static_cast<Block*>(record)->active.store(false);
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the StatBlocks class.
+    ********************************************************************/
+	StatBlocks() : blocks(nullptr), id(ThreadSlots::Register())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the StatBlocks class.
+    ********************************************************************/
+	~StatBlocks()
+	{
+		ThreadSlots::Unregister(id);
+
+		Block* block = blocks.load();
+		while(block != nullptr)
+		{
+			Block* temp = block;
+			block = block->next;
+			delete temp;
+		}
+	}
+
+	StatBlocks(StatBlocks const&) = delete;
+	StatBlocks& operator=(StatBlocks const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's block, claiming one the first time
+		this thread counts anything.
+
+	  \return
+	  	The calling thread's block.
+    ********************************************************************/
+	Counters* Local()
+	{
+		void* found = ThreadSlots::Find(id);
+		if(found)
+			return static_cast<Block*>(found);
+
+		Block* block = blocks.load();
+		for(; block != nullptr; block = block->next)
+		{
+			bool f = false;
+			if(!block->active.load() && block->active.compare_exchange_strong(f, true))
+				break;
+		}
+
+		if(block == nullptr)
+		{
+			block = new Block();
+			block->active.store(true);
+
+			Block* oldBlock = nullptr;
+			do
+			{
+				oldBlock = blocks.load();
+				block->next = oldBlock;
+			} while (!blocks.compare_exchange_weak(oldBlock, block));
+		}
+
+		if(!ThreadSlots::Exiting())
+			ThreadSlots::Add(id, block, &StatBlocks::OnThreadExit, this);
+		return block;
+	}
+
+	/*!******************************************************************
+      \brief
+        Visits every block created so far.
+
+	  \param visit
+	  	Called with each block's counters.
+    ********************************************************************/
+	template <typename Visitor>
+	void ForEach(Visitor visit) const
+	{
+		for(Block* block = blocks.load(); block != nullptr; block = block->next)
+			visit(static_cast<Counters const&>(*block));
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class MemoryBank
+  \brief  
+    A lock-free memory manager for Object instances. Storage is
+	carved out of slabs that are added on demand, and every thread keeps
+	a small cache of free slots that is refilled from and drained to a
+	global lock-free stack in batches.
+
+    Non-Core Operations Include:
+
+    -Returns a pointer to a "new" Object.
+    -Stores an Object pointer back into the available list.
+
+*/
+/**************************************************************************/
+template <typename Object>
+class MemoryBank 
+{
+    static const unsigned firstSlab = 32;    // # of slots in the first slab; each later slab doubles
+    static const unsigned maxSlabs = 24;     // Upper bound on the # of slabs
+    static const unsigned batchSize = 32;    // # of slots moved to/from the global stack at once
+    static const unsigned cacheSize = 2 * batchSize; // # of slots a thread may hold onto
+    static const std::uint32_t none = 0xFFFFFFFF;    // Index representing "no slot"
+
+    /*!
+      \struct Slot
+      \brief
+        Storage for one Object, plus the links used
+        while the slot sits on the global free stack.
+    */
+    struct Slot
+    {
+        std::atomic<std::uint32_t> next;      // Next slot within the same batch
+        std::atomic<std::uint32_t> nextBatch; // First slot of the next batch on the stack
+        std::uint32_t index;                  // This slot's own index within the bank
+        alignas(Object) unsigned char storage[sizeof(Object)];
+    };
+
+    /*!
+      \struct Cache
+      \brief
+        One thread's private stack of free slots.
+    */
+    struct Cache
+    {
+        std::uint32_t slots[cacheSize];   // Indices of the cached free slots
+        unsigned count = 0;               // # of slots currently cached
+        std::atomic<bool> active{false};  // Whether a thread currently owns this cache
+        Cache* next = nullptr;            // Pointer to the next cache owned by the bank
+#ifdef LFSV_STATS
+        std::atomic<std::uint64_t> gets{0};        // # of slots handed out through this cache
+        std::atomic<std::uint64_t> stores{0};      // # of slots returned through this cache
+        std::atomic<std::uint64_t> refills{0};     // # of batches pulled in
+        std::atomic<std::uint64_t> drains{0};      // # of batches pushed out
+        std::atomic<std::uint64_t> sharedNanos{0}; // Time spent refilling and draining
+#endif
+    };
+
+    std::atomic<Slot*> slabs[maxSlabs];     // Every slab allocated so far
+    std::atomic<unsigned> slabCount;        // # of slabs reserved so far
+    std::atomic<std::uint64_t> freeHead;    // Global stack of batches: (tag << 32) | index
+    std::atomic<Cache*> caches;             // Every cache created for this bank
+    std::uint64_t id;                       // This bank's id within ThreadSlots
+
+    /*!******************************************************************
+      \brief
+        Returns the slot at a given index.
+
+      \param index
+        The index of the slot.
+
+      \return
+        The slot.
+    ********************************************************************/
+    Slot* At(std::uint32_t index)
+    {
+        unsigned s = SlabOf(index);
+        return slabs[s].load(std::memory_order_acquire) + (index - SlabBase(s));
+    }
+
+    /*!******************************************************************
+      \brief
+        Returns the index of the first slot of a slab. Slab 0 and slab 1
+        hold firstSlab slots each, and every later slab holds as many
+        slots as all the slabs before it, so a bank that is only ever
+        lightly used stays small.
+
+      \param s
+        The slab.
+
+      \return
+        The index of its first slot.
+    ********************************************************************/
+    static std::uint32_t SlabBase(unsigned s)
+    {
+        return s == 0 ? 0 : firstSlab << (s - 1);
+    }
+
+    /*!******************************************************************
+      \brief
+        Returns the slab holding the slot at a given index.
+
+      \param index
+        The index of the slot.
+
+      \return
+        The slab.
+    ********************************************************************/
+    static unsigned SlabOf(std::uint32_t index)
+    {
+        unsigned s = 0;
+        for(std::uint32_t i = index / firstSlab; i != 0; i >>= 1)
+            ++s;
+        return s;
+    }
+
+    /*!******************************************************************
+      \brief
+        Pushes a chain of slots (linked through next) onto the global
+        stack as a single batch.
+
+      \param first
+        The index of the first slot of the chain.
+    ********************************************************************/
+    void PushBatch(std::uint32_t first)
+    {
+        Slot* slot = At(first);
+        std::uint64_t head = freeHead.load();
+        do
+        {
+            slot->nextBatch.store(static_cast<std::uint32_t>(head));
+        } while (!freeHead.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | first));
+    }
+
+    /*!******************************************************************
+      \brief
+        Pops a batch of slots off of the global stack. The tag stored
+        in the upper half of the head prevents ABA.
+
+      \return
+        The index of the first slot of the batch, or none if empty.
+    ********************************************************************/
+    std::uint32_t PopBatch()
+    {
+        std::uint64_t head = freeHead.load();
+        for(;;)
+        {
+            std::uint32_t first = static_cast<std::uint32_t>(head);
+            if(first == none)
+                return none;
+
+            std::uint64_t next = ((head >> 32) + 1) << 32 | At(first)->nextBatch.load();
+            if(freeHead.compare_exchange_weak(head, next))
+                return first;
+        }
+    }
+
+    /*!******************************************************************
+      \brief
+        Adds a new slab to the bank. One batch of its slots goes to the
+        caller and the rest are pushed onto the global stack.
+
+      \return
+        The index of the first slot of the caller's batch.
+    ********************************************************************/
+    std::uint32_t Grow()
+    {
+        unsigned s = slabCount.fetch_add(1);
+        if(s >= maxSlabs)
+        {
+            slabCount.fetch_sub(1);
+            throw std::bad_alloc();
+        }
+
+        std::uint32_t base = SlabBase(s);
+        std::uint32_t slabSize = SlabBase(s + 1) - base;
+        Slot* slab = new Slot[slabSize];
+        for(unsigned i = 0; i < slabSize; ++i)
+        {
+            slab[i].index = base + i;
+            slab[i].next.store((i + 1) % batchSize == 0 ? none : base + i + 1);
+        }
+        slabs[s].store(slab, std::memory_order_release);
+
+        for(unsigned i = batchSize; i < slabSize; i += batchSize)
+            PushBatch(base + i);
+
+        return base;
+    }
+
+    /*!******************************************************************
+      \brief
+        Refills an empty cache with one batch of free slots.
+
+      \param cache
+        The cache to refill.
+    ********************************************************************/
+    void Refill(Cache* cache)
+    {
+        LFSV_STAT(auto start = std::chrono::steady_clock::now());
+
+        std::uint32_t index = PopBatch();
+        if(index == none)
+            index = Grow();
+
+        for(; index != none; index = At(index)->next.load())
+            cache->slots[cache->count++] = index;
+
+        LFSV_STAT(Bump(cache->refills));
+        LFSV_STAT(Bump(cache->sharedNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+
+    /*!******************************************************************
+      \brief
+        Moves slots from the top of a cache onto the global stack as a
+        single batch.
+
+      \param cache
+        The cache to drain.
+
+      \param amount
+        The # of slots to move.
+    ********************************************************************/
+    void Drain(Cache* cache, unsigned amount)
+    {
+        if(amount == 0)
+            return;
+
+        LFSV_STAT(auto start = std::chrono::steady_clock::now());
+
+        unsigned first = cache->count - amount;
+        for(unsigned i = first; i + 1 < cache->count; ++i)
+            At(cache->slots[i])->next.store(cache->slots[i + 1]);
+        At(cache->slots[cache->count - 1])->next.store(none);
+
+        PushBatch(cache->slots[first]);
+        cache->count = first;
+
+        LFSV_STAT(Bump(cache->drains));
+        LFSV_STAT(Bump(cache->sharedNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+
+    /*!******************************************************************
+      \brief
+        Hands a cache back to its bank when the owning thread exits.
+
+      \param owner
+        The bank the cache belongs to.
+
+      \param record
+        The cache.
+    ********************************************************************/
+    static void OnThreadExit(void* owner, void* record)
+    {
+        MemoryBank* bank = static_cast<MemoryBank*>(owner);
+        Cache* cache = static_cast<Cache*>(record);
+        bank->Drain(cache, cache->count);
+        cache->active.store(false);
+    }
+
+    /*!******************************************************************
+      \brief
+        Returns the calling thread's cache, claiming one if needed.
+
+      \return
+        The cache, or nullptr if this thread is already shutting down.
+    ********************************************************************/
+    Cache* LocalCache()
+    {
+        void* found = ThreadSlots::Find(id);
+        if(found)
+            return static_cast<Cache*>(found);
+        if(ThreadSlots::Exiting())
+            return nullptr;
+
+        // Try to reuse a cache left behind by an exited thread
+        Cache* cache = caches.load();
+        for(; cache != nullptr; cache = cache->next)
+        {
+            bool f = false;
+            if(!cache->active.load() && cache->active.compare_exchange_strong(f, true))
+                break;
+        }
+
+        if(cache == nullptr)
+        {
+            cache = new Cache();
+            cache->active.store(true);
+
+            Cache* oldCache = nullptr;
+            do
+            {
+                oldCache = caches.load();
+                cache->next = oldCache;
+            } while (!caches.compare_exchange_weak(oldCache, cache));
+        }
+
+        ThreadSlots::Add(id, cache, &MemoryBank::OnThreadExit, this);
+        return cache;
+    }
+
+    public:
+
+    /*!******************************************************************
+      \brief
+        Constructor for the MemoryBank class. Slabs are only allocated
+        once slots are first requested.
+    ********************************************************************/
+    MemoryBank() : slabCount(0), freeHead(none), caches(nullptr), id(ThreadSlots::Register())
+    {
+        for(unsigned i = 0; i < maxSlabs; ++i)
+            slabs[i].store(nullptr);
+    }
+
+    /*!******************************************************************
+      \brief
+        Destructor for the MemoryBank class.
+    ********************************************************************/
+    ~MemoryBank()
+    {
+        // No thread may hand a cache back once this returns
+        ThreadSlots::Unregister(id);
+
+        Cache* cache = caches.load();
+        while(cache != nullptr)
+        {
+            Cache* temp = cache;
+            cache = cache->next;
+            delete temp;
+        }
+
+        // Destroy all allocated space; all pointers should be returned by this point
+        for(unsigned i = 0; i < slabCount.load() && i < maxSlabs; ++i)
+            delete[] slabs[i].load();
+    }
+
+    /*!******************************************************************
+      \brief
+        Returns a pointer to a "new" Object. The memory is uninitialized,
+        so the caller must construct the object in place.
+
+      \return
+        The new Object pointer.
+    ********************************************************************/
+    Object* get()
+    {
+        Cache* cache = LocalCache();
+        std::uint32_t index;
+
+        if(cache == nullptr)
+        {
+            // Thread is exiting; take a whole batch and keep only one slot
+            index = PopBatch();
+            if(index == none)
+                index = Grow();
+            if(At(index)->next.load() != none)
+                PushBatch(At(index)->next.load());
+        }
+        else
+        {
+            if(cache->count == 0)
+                Refill(cache);
+            index = cache->slots[--cache->count];
+            LFSV_STAT(Bump(cache->gets));
+        }
+
+        return reinterpret_cast<Object*>(At(index)->storage);
+    }
+
+    /*!******************************************************************
+      \brief
+        Stores an Object pointer back into the available list. The
+        caller must have destroyed the object already.
+
+      \param pointer
+        The pointer that will be returned to the memory manager.
+    ********************************************************************/
+    void store(Object* pointer)
+    {
+        Slot* slot = reinterpret_cast<Slot*>(
+            reinterpret_cast<unsigned char*>(pointer) - offsetof(Slot, storage));
+        Cache* cache = LocalCache();
+
+        if(cache == nullptr)
+        {
+            slot->next.store(none);
+            PushBatch(slot->index);
+            return;
+        }
+
+        if(cache->count == cacheSize)
+            Drain(cache, batchSize);
+        cache->slots[cache->count++] = slot->index;
+        LFSV_STAT(Bump(cache->stores));
+    }
+
+#ifdef LFSV_STATS
+    /*!******************************************************************
+      \brief
+        Sums every thread's cache counters. Slots taken or returned by
+        threads that were already exiting are not counted.
+
+      \return
+        The bank's occupancy and shared-path traffic.
+    ********************************************************************/
+    BankStats Stats() const
+    {
+        BankStats stats;
+        std::uint64_t gets = 0;
+        std::uint64_t stores = 0;
+        for(Cache* cache = caches.load(); cache != nullptr; cache = cache->next)
+        {
+            gets += cache->gets.load(std::memory_order_relaxed);
+            stores += cache->stores.load(std::memory_order_relaxed);
+            stats.refills += cache->refills.load(std::memory_order_relaxed);
+            stats.drains += cache->drains.load(std::memory_order_relaxed);
+            stats.sharedNanos += cache->sharedNanos.load(std::memory_order_relaxed);
+        }
+        unsigned count = slabCount.load();
+        stats.capacity = SlabBase(count < maxSlabs ? count : maxSlabs);
+        stats.inUse = gets > stores ? static_cast<std::size_t>(gets - stores) : 0;
+        return stats;
+    }
+#endif
+};
+
+const unsigned scanSize = 10;  // Minimum # of pointers to collect before scanning
+const unsigned scanFactor = 2; // Scan once a retired list holds this many times the live hazard count
+
+/*!******************************************************************
+  \brief
+    Reclaim function for a pointer allocated with a plain new.
+
+  \param pointer
+	The object to delete.
+********************************************************************/
+template <typename T>
+void DeleteObject(void* pointer)
+{
+	delete static_cast<T*>(pointer);
+}
+
+/**************************************************************************/
+/*!
+  \class RetiredPointer
+  \brief  
+    A retired pointer bundled with a copy of the function that reclaims
+	it, with the function's type erased. Lets one retired list hold
+	pointers to any mix of node types, each reclaimed its own way.
+
+	The function is kept inline, so it must be small and trivially
+	copyable: a function pointer, or a lambda capturing a pointer or two.
+
+    Non-Core Operations Include:
+
+    -Returns the retired pointer.
+	-Reclaims the retired pointer.
+
+*/
+/**************************************************************************/
+class RetiredPointer
+{
+	static const unsigned storageSize = 2 * sizeof(void*); // Room for a reclaim function's captures
+
+	void* pointer;                                     // The retired pointer
+	void (*invoke)(void const*, void*);                // Calls the stored function on the pointer
+	alignas(void*) unsigned char storage[storageSize]; // The reclaim function itself
+
+	/*!******************************************************************
+	  \brief
+		Calls a stored reclaim function of a known type.
+
+	  \param function
+		The stored function.
+
+	  \param pointer
+		The pointer to reclaim.
+	********************************************************************/
+	template <typename Reclaim>
+	static void Invoke(void const* function, void* pointer)
+	{
+		(*static_cast<Reclaim const*>(function))(pointer);
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the RetiredPointer class.
+
+	  \param retired
+	  	The pointer that has just been unlinked.
+
+	  \param reclaim
+	  	Called with the pointer once it is safe to reclaim.
+    ********************************************************************/
+	template <typename Reclaim>
+	RetiredPointer(void* retired, Reclaim const& reclaim)
+		: pointer(retired), invoke(&RetiredPointer::Invoke<Reclaim>)
+	{
+		static_assert(sizeof(Reclaim) <= storageSize && alignof(Reclaim) <= alignof(void*),
+			"RetiredPointer: reclaim function is too large to store");
+		static_assert(std::is_trivially_copyable<Reclaim>::value,
+			"RetiredPointer: reclaim function must be trivially copyable");
+
+		new (storage) Reclaim(reclaim);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the retired pointer.
+
+	  \return
+	  	The retired pointer.
+    ********************************************************************/
+	void* Get() const
+	{
+		return pointer;
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands the pointer to its reclaim function.
+    ********************************************************************/
+	void Reclaim() const
+	{
+		invoke(storage, pointer);
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class HazardDomain
+  \brief  
+    A set of "hazard-pointer" slots owned by a single container. Each
+	thread claims one record of slots from the domain the first time it
+	touches the container and keeps it for as long as the thread lives,
+	so protecting a pointer is a single store plus a validating load.
+	Each record also holds the pointers its thread has retired.
+
+	Records are stored contiguously in cache-line-aligned slabs, so a
+	scan walks memory linearly and no two threads' slots share a line.
+	Slabs whose records have all been released are unlinked and freed.
+
+    Non-Core Operations Include:
+
+    -Returns the calling thread's record, claiming one if needed.
+	-Collects every pointer currently protected within the domain.
+	-Checks whether a retired list is long enough to scan.
+	-Reclaims every retired pointer that is no longer protected.
+	-Visits every record currently linked into the domain.
+	-Moves retired pointers left behind by exited threads to a caller.
+
+*/
+/**************************************************************************/
+class HazardDomain
+{
+	public:
+
+	static const unsigned slotsPerThread = 4; // # of pointers one thread may protect at once
+	static const unsigned cacheLine = 64;     // Assumed size of a cache line, in bytes
+
+	struct Slab;
+
+	/*!
+	  \struct Record
+	  \brief
+	    One thread's hazard slots and retired list within the domain.
+	    Padded out to whole cache lines.
+	*/
+	struct alignas(cacheLine) Record
+	{
+		std::atomic<void*> slots[slotsPerThread]; // Pointers this thread is protecting
+		std::vector<RetiredPointer> retired;      // Pointers retired but not yet reclaimed
+		std::vector<void*> hazards;               // Scratch space for this thread's scans
+		std::atomic<bool> active;                 // Whether a thread currently owns this record
+		unsigned heldSlots;                       // Bitmask of slots held long-term; owner only
+		Slab* slab;                               // The slab this record lives in
+
+		/*!******************************************************************
+		  \brief
+			Protects the pointer currently held by an atomic source.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \param slot
+			Which of this record's slots to store the hazard in.
+
+		  \return
+			The protected pointer; safe to read until the slot is cleared.
+		********************************************************************/
+		template <typename T>
+		T* Protect(std::atomic<T*> const& source, unsigned slot = 0)
+		{
+			T* pointer = source.load();
+			for(;;)
+			{
+				slots[slot].store(pointer);
+				T* validated = source.load();
+				if(validated == pointer)
+					return pointer;
+				pointer = validated;
+			}
+		}
+
+		/*!******************************************************************
+		  \brief
+			Scrubs the pointer data off of one of this record's slots.
+
+		  \param slot
+			The slot to clear.
+		********************************************************************/
+		void Clear(unsigned slot = 0)
+		{
+			slots[slot].store(nullptr, std::memory_order_release);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Reserves one of this record's slots for a long-lived hazard,
+			such as a snapshot. Slot 0 is never handed out, as it is used
+			by every single operation.
+
+		  \return
+			The reserved slot.
+		********************************************************************/
+		unsigned HoldSlot()
+		{
+			for(unsigned i = 1; i < slotsPerThread; ++i)
+			{
+				if(!(heldSlots & (1u << i)))
+				{
+					heldSlots |= 1u << i;
+					return i;
+				}
+			}
+			throw std::length_error("HazardDomain: too many hazards held by one thread");
+		}
+
+		/*!******************************************************************
+		  \brief
+			Clears a slot reserved with HoldSlot() and makes it available
+			again.
+
+		  \param slot
+			The slot to release.
+		********************************************************************/
+		void DropSlot(unsigned slot)
+		{
+			Clear(slot);
+			heldSlots &= ~(1u << slot);
+		}
+	};
+
+	static const unsigned slabRecords = 16;  // # of records held by each slab
+	static const unsigned maxSlabs = 256;    // Upper bound on the # of slabs
+	static const unsigned unlinked = 0xFFFFFFFF; // Slab use count marking a slab being freed
+
+	/*!
+	  \struct Slab
+	  \brief
+	    A contiguous block of records, and a count of how many of them
+	    are currently reserved by threads.
+	*/
+	struct Slab
+	{
+		Record records[slabRecords];                     // The records themselves
+		alignas(cacheLine) std::atomic<unsigned> used;   // # of records reserved, or unlinked
+	};
+
+	private:
+
+	std::atomic<Slab*> slabs[maxSlabs];  // Slabs currently linked into the domain
+	std::atomic<unsigned> slabCount;     // One past the highest slab index ever used
+	std::atomic<int> length;             // # of records currently claimed
+	std::atomic<std::size_t> liveHazards; // # of non-null hazards seen by the latest scan
+	std::atomic<int> traversers;         // # of threads currently walking the slabs
+	std::uint64_t id;                    // This domain's id within ThreadSlots
+
+	std::mutex coldMutex;                // Guards the two lists below; cold paths only
+	std::vector<Slab*> unlinkedSlabs;    // Unlinked slabs waiting for traversers to leave
+	std::vector<RetiredPointer> orphans; // Retired pointers left behind by exited threads
+	std::atomic<bool> hasOrphans;        // Whether orphans is non-empty
+
+	/*!
+	  \struct Traversal
+	  \brief
+	    Marks the calling thread as walking the slabs while in scope, so
+	    unlinked slabs are not freed from underneath it.
+	*/
+	struct Traversal
+	{
+		HazardDomain& domain;
+		explicit Traversal(HazardDomain& d) : domain(d) { domain.traversers.fetch_add(1); }
+		~Traversal() { domain.traversers.fetch_sub(1); }
+	};
+
+	/*!******************************************************************
+      \brief
+        Frees every unlinked slab if no thread is walking the slabs.
+		Must be called with coldMutex held.
+    ********************************************************************/
+	void FreeUnlinked()
+	{
+		if(traversers.load() != 0)
+			return;
+
+		for(Slab* slab : unlinkedSlabs)
+			delete slab;
+		unlinkedSlabs.clear();
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands a record back to the domain. Anything still on its retired
+		list moves to the orphan list, and the record's slab is freed if
+		this was its last reserved record.
+
+	  \param record
+	  	The record to release.
+    ********************************************************************/
+	void Release(Record* record)
+	{
+		for(unsigned i = 0; i < slotsPerThread; ++i)
+			record->Clear(i);
+
+		if(!record->retired.empty())
+		{
+			std::lock_guard<std::mutex> lock(coldMutex);
+			orphans.insert(orphans.end(), record->retired.begin(), record->retired.end());
+			hasOrphans.store(true);
+		}
+		record->retired.clear();
+		record->retired.shrink_to_fit();
+		record->hazards.clear();
+		record->hazards.shrink_to_fit();
+
+		Slab* slab = record->slab;
+		record->heldSlots = 0;
+		record->active.store(false);
+		length.fetch_sub(1);
+
+		// The first slab is always kept; others go once they are empty
+		unsigned zero = 0;
+		if(slab->used.fetch_sub(1) != 1 || slab == slabs[0].load() ||
+		   !slab->used.compare_exchange_strong(zero, unlinked))
+			return;
+
+		for(unsigned i = 0; i < slabCount.load(); ++i)
+		{
+			Slab* expected = slab;
+			if(slabs[i].compare_exchange_strong(expected, nullptr))
+				break;
+		}
+
+		std::lock_guard<std::mutex> lock(coldMutex);
+		unlinkedSlabs.push_back(slab);
+		FreeUnlinked();
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands a record back to its domain when the owning thread exits.
+
+	  \param owner
+	  	The domain the record belongs to.
+
+	  \param record
+	  	The record to release.
+    ********************************************************************/
+	static void OnThreadExit(void* owner, void* record)
+	{
+		static_cast<HazardDomain*>(owner)->Release(static_cast<Record*>(record));
+	}
+
+	/*!******************************************************************
+      \brief
+        Reserves a record within a slab, unless the slab is full or is
+		being unlinked.
+
+	  \param slab
+	  	The slab to reserve a record in.
+
+	  \return
+	  	Whether a record was reserved.
+    ********************************************************************/
+	static bool Reserve(Slab* slab)
+	{
+		unsigned used = slab->used.load();
+		while(used < slabRecords)
+			if(slab->used.compare_exchange_weak(used, used + 1))
+				return true;
+		return false;
+	}
+
+	/*!******************************************************************
+      \brief
+        Claims a record from a slab in which one has been reserved.
+
+	  \param slab
+	  	The slab to claim a record from.
+
+	  \return
+	  	The claimed record.
+    ********************************************************************/
+	Record* ClaimIn(Slab* slab)
+	{
+		for(;;)
+		{
+			for(Record& record : slab->records)
+			{
+				bool f = false;
+				if(!record.active.load() && record.active.compare_exchange_strong(f, true))
+				{
+					length.fetch_add(1);
+					return &record;
+				}
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Claims a released record, or links in a new slab if every slab
+		is full.
+
+	  \return
+	  	The claimed record.
+    ********************************************************************/
+	Record* Claim()
+	{
+		{
+			Traversal traversal(*this);
+			for(unsigned i = 0; i < slabCount.load(); ++i)
+			{
+				Slab* slab = slabs[i].load();
+				if(slab != nullptr && Reserve(slab))
+					return ClaimIn(slab);
+			}
+		}
+
+		Slab* slab = new Slab();
+		for(Record& record : slab->records)
+		{
+			for(unsigned i = 0; i < slotsPerThread; ++i)
+				record.slots[i].store(nullptr);
+			record.active.store(false);
+			record.heldSlots = 0;
+			record.slab = slab;
+		}
+		slab->used.store(1);
+		Record* record = ClaimIn(slab);
+
+		// Link the slab into the first free entry
+		for(unsigned i = 0; i < maxSlabs; ++i)
+		{
+			Slab* expected = nullptr;
+			if(slabs[i].compare_exchange_strong(expected, slab))
+			{
+				unsigned count = slabCount.load();
+				while(count <= i && !slabCount.compare_exchange_weak(count, i + 1))
+				{}
+				return record;
+			}
+		}
+
+		delete slab;
+		throw std::bad_alloc();
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the HazardDomain class.
+    ********************************************************************/
+	HazardDomain() : slabCount(0), length(0), liveHazards(0), traversers(0), id(ThreadSlots::Register()),
+		coldMutex(), unlinkedSlabs(), orphans(), hasOrphans(false)
+	{
+		for(unsigned i = 0; i < maxSlabs; ++i)
+			slabs[i].store(nullptr);
+	}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the HazardDomain class. The owning container must
+		have reclaimed every retired pointer by this point.
+    ********************************************************************/
+	~HazardDomain()
+	{
+		// No thread may hand a record back once this returns
+		ThreadSlots::Unregister(id);
+
+		for(unsigned i = 0; i < slabCount.load(); ++i)
+			delete slabs[i].load();
+		for(Slab* slab : unlinkedSlabs)
+			delete slab;
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's record, claiming one the first time
+		this thread touches the domain. A thread that is already exiting
+		claims a record that is only freed along with the domain.
+
+	  \return
+	  	The calling thread's record.
+    ********************************************************************/
+	Record* Local()
+	{
+		void* found = ThreadSlots::Find(id);
+		if(found)
+			return static_cast<Record*>(found);
+
+		Record* record = Claim();
+		if(!ThreadSlots::Exiting())
+			ThreadSlots::Add(id, record, &HazardDomain::OnThreadExit, this);
+		return record;
+	}
+
+	/*!******************************************************************
+      \brief
+        Collects every pointer currently protected within the domain.
+
+	  \param activePointers
+	  	The list to append protected pointers to.
+    ********************************************************************/
+	void Collect(std::vector<void*>& activePointers)
+	{
+		Traversal traversal(*this);
+		for(unsigned i = 0; i < slabCount.load(); ++i)
+		{
+			Slab* slab = slabs[i].load();
+			if(slab == nullptr)
+				continue;
+
+			for(Record& record : slab->records)
+			{
+				for(unsigned j = 0; j < slotsPerThread; ++j)
+				{
+					void* pointer = record.slots[j].load();
+					if(pointer != nullptr)
+						activePointers.push_back(pointer);
+				}
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Checks whether a record's retired list is long enough to scan.
+		The threshold follows the # of hazards seen live by the latest
+		scan (R = k * H), so a scan reclaims about (k - 1) * H pointers
+		and a retired list stays near (k + 1) * H at most.
+
+	  \param record
+	  	The record whose retired list should be checked.
+
+	  \return
+	  	Whether the retired list should be scanned now.
+    ********************************************************************/
+	bool ShouldScan(Record* record)
+	{
+		std::size_t hazardCount = liveHazards.load(std::memory_order_relaxed);
+		return record->retired.size() >= std::max<std::size_t>(scanSize, scanFactor * hazardCount);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of non-null hazards seen by the latest scan.
+
+	  \return
+	  	The # of live hazards.
+    ********************************************************************/
+	std::size_t LiveHazards() const
+	{
+		return liveHazards.load(std::memory_order_relaxed);
+	}
+
+	/*!******************************************************************
+      \brief
+        Scrub through a record's retired list (plus any orphans) and
+		reclaim every pointer that no thread is protecting. The hazard
+		snapshot is sorted once, so each lookup is O(log H).
+
+	  \param record
+	  	The record whose retired list should be scrubbed.
+
+	  \param reclaimed
+	  	Called with each pointer after it has been reclaimed.
+    ********************************************************************/
+	template <typename Reclaimed>
+	void Scan(Record* record, Reclaimed reclaimed)
+	{
+		std::vector<void*>& activePointers = record->hazards;
+		std::vector<RetiredPointer>& retiredList = record->retired;
+
+		AdoptOrphans(retiredList);
+
+		// Collect all still valid pointers
+		activePointers.clear();
+		Collect(activePointers);
+		std::sort(activePointers.begin(), activePointers.end());
+		liveHazards.store(activePointers.size(), std::memory_order_relaxed);
+
+		// Keep the pointers still in use, reclaim the rest oldest first. The
+		// pools recycling their memory are stacks, so the most recently
+		// retired (and likeliest still cached) memory is the first reused
+		std::size_t kept = 0;
+		for(std::size_t i = 0; i < retiredList.size(); ++i)
+		{
+			if(std::binary_search(activePointers.begin(), activePointers.end(), retiredList[i].Get()))
+				retiredList[kept++] = retiredList[i];
+			else
+			{
+				retiredList[i].Reclaim();
+				reclaimed();
+			}
+		}
+		retiredList.erase(retiredList.begin() + static_cast<std::ptrdiff_t>(kept), retiredList.end());
+	}
+
+	/*!******************************************************************
+      \brief
+        Visits every record currently linked into the domain. Used by
+		owners to reclaim every retired list once no other thread is
+		running.
+
+	  \param visit
+	  	Called with each record.
+    ********************************************************************/
+	template <typename Visitor>
+	void ForEachRecord(Visitor visit)
+	{
+		Traversal traversal(*this);
+		for(unsigned i = 0; i < slabCount.load(); ++i)
+		{
+			Slab* slab = slabs[i].load();
+			if(slab == nullptr)
+				continue;
+
+			for(Record& record : slab->records)
+				visit(&record);
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Moves retired pointers left behind by exited threads onto a
+		caller's retired list. Cheap when there are none.
+
+	  \param retired
+	  	The list to append the orphaned pointers to.
+    ********************************************************************/
+	void AdoptOrphans(std::vector<RetiredPointer>& retired)
+	{
+		if(!hasOrphans.load())
+			return;
+
+		std::lock_guard<std::mutex> lock(coldMutex);
+		retired.insert(retired.end(), orphans.begin(), orphans.end());
+		orphans.clear();
+		hasOrphans.store(false);
+	}
+};
+
+#ifdef LFSV_STATS
+/*!
+  \struct ReclaimCounters
+  \brief
+    One thread's retire and scan counters, kept by either policy.
+*/
+struct ReclaimCounters
+{
+	std::atomic<std::uint64_t> retired{0};    // # of pointers this thread retired
+	std::atomic<std::uint64_t> scans{0};      // # of scans this thread ran
+	std::atomic<std::uint64_t> scanNanos{0};  // Time this thread spent scanning
+	std::atomic<std::uint64_t> maxRetired{0}; // Longest retired list this thread has held
+};
+
+/*!******************************************************************
+  \brief
+    Records a retire, and the length of the retired list it produced,
+	in the calling thread's counters.
+
+  \param counters
+	The calling thread's counters.
+
+  \param length
+	The length of the retired list after the retire.
+********************************************************************/
+inline void CountRetire(ReclaimCounters* counters, std::size_t length)
+{
+	Bump(counters->retired);
+	if(length > counters->maxRetired.load(std::memory_order_relaxed))
+		counters->maxRetired.store(length, std::memory_order_relaxed);
+}
+
+/*!******************************************************************
+  \brief
+    Sums every thread's retire and scan counters.
+
+  \param blocks
+	The per-thread counters to sum.
+
+  \param unreclaimed
+	The # of pointers retired but not yet reclaimed.
+
+  \return
+	The totals; hazards is left for the policy to fill in.
+********************************************************************/
+inline ReclaimStats SumReclaim(StatBlocks<ReclaimCounters> const& blocks, std::size_t unreclaimed)
+{
+	ReclaimStats stats;
+	blocks.ForEach([&stats](ReclaimCounters const& counters)
+	{
+		stats.retired += counters.retired.load(std::memory_order_relaxed);
+		stats.scans += counters.scans.load(std::memory_order_relaxed);
+		stats.scanNanos += counters.scanNanos.load(std::memory_order_relaxed);
+		stats.maxRetired = std::max<std::size_t>(stats.maxRetired,
+			counters.maxRetired.load(std::memory_order_relaxed));
+	});
+	stats.reclaimed = stats.retired > unreclaimed ? stats.retired - unreclaimed : 0;
+	return stats;
+}
+#endif
+
+/**************************************************************************/
+/*!
+  \class HazardReclaimer
+  \brief  
+    Reclamation policy built on a HazardDomain. Readers publish the exact
+	pointer they are about to use, so a retired pointer is reclaimed as
+	soon as no thread names it, at the cost of a store and a validating
+	load on every protected read.
+
+    Non-Core Operations Include:
+
+    -Protects a pointer for the span of a single operation (Guard).
+	-Protects a pointer for as long as a handle lives (Pin).
+	-Retires a pointer, scanning once enough have piled up.
+	-Reclaims every retired pointer once no other thread is running.
+	-Returns the # of pointers retired but not yet reclaimed.
+
+*/
+/**************************************************************************/
+class HazardReclaimer
+{
+	HazardDomain domain;                  // Hazard slots and retired lists
+	std::atomic<std::size_t> unreclaimed; // # of pointers retired but not yet reclaimed
+#ifdef LFSV_STATS
+	StatBlocks<ReclaimCounters> stats;    // Per-thread retire and scan counters
+#endif
+
+	public:
+
+	/*!
+	  \class Guard
+	  \brief
+	    Protects one pointer at a time for the span of a single
+	    operation, using slot 0 of the calling thread's record. Only one
+	    guard may be alive per thread at a time.
+	*/
+	class Guard
+	{
+		HazardDomain::Record* record; // The calling thread's hazard record
+
+		public:
+
+		explicit Guard(HazardReclaimer& reclaimer) : record(reclaimer.domain.Local())
+		{}
+
+		~Guard()
+		{
+			record->Clear();
+		}
+
+		Guard(Guard const&) = delete;
+		Guard& operator=(Guard const&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Protects the pointer currently held by an atomic source,
+			replacing whatever this guard protected before.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The protected pointer; safe to read until Clear().
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			return record->Protect(source);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Stops protecting the current pointer.
+		********************************************************************/
+		void Clear()
+		{
+			record->Clear();
+		}
+	};
+
+	/*!
+	  \class Pin
+	  \brief
+	    Protects one pointer for as long as the handle lives, using a
+	    slot reserved with HoldSlot(). Must be destroyed on the thread
+	    that created it.
+	*/
+	class Pin
+	{
+		HazardDomain::Record* record; // The hazard record holding the pin
+		unsigned slot;                // The slot within the record holding the pin
+
+		public:
+
+		explicit Pin(HazardReclaimer& reclaimer)
+			: record(reclaimer.domain.Local()), slot(record->HoldSlot())
+		{}
+
+		Pin(Pin&& other) : record(other.record), slot(other.slot)
+		{
+			other.record = nullptr;
+		}
+
+		~Pin()
+		{
+			if(record)
+				record->DropSlot(slot);
+		}
+
+		Pin(Pin const&) = delete;
+		Pin& operator=(Pin const&) = delete;
+		Pin& operator=(Pin&&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Protects the pointer currently held by an atomic source.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The protected pointer; safe to read until the pin is destroyed.
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			return record->Protect(source, slot);
+		}
+	};
+
+	/*!******************************************************************
+      \brief
+        Constructor for the HazardReclaimer class.
+    ********************************************************************/
+	HazardReclaimer() : domain(), unreclaimed(0)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Place a pointer into the calling thread's retired list, and scan
+		that list once it has grown long enough.
+
+	  \param pointer
+	  	The pointer that has just been unlinked.
+
+	  \param reclaim
+	  	Called with the pointer once it is safe to reclaim. Kept with the
+		pointer (see RetiredPointer), so pointers of any type may share
+		the reclaimer.
+    ********************************************************************/
+	template <typename Reclaim>
+	void Retire(void* pointer, Reclaim reclaim)
+	{
+		HazardDomain::Record* record = domain.Local();
+		record->retired.emplace_back(pointer, reclaim);
+		unreclaimed.fetch_add(1, std::memory_order_relaxed);
+		LFSV_STAT(ReclaimCounters* counters = stats.Local());
+		LFSV_STAT(CountRetire(counters, record->retired.size()));
+
+		if(domain.ShouldScan(record))
+		{
+			LFSV_STAT(auto start = std::chrono::steady_clock::now());
+			LFSV_TRACE(Trace(TraceEvent::ScanBegin));
+			std::size_t reclaimed = 0;
+			domain.Scan(record, [this, &reclaimed]()
+			{
+				unreclaimed.fetch_sub(1, std::memory_order_relaxed);
+				++reclaimed;
+			});
+			LFSV_TRACE(Trace(TraceEvent::ScanEnd, reclaimed));
+			LFSV_STAT(Bump(counters->scans));
+			LFSV_STAT(Bump(counters->scanNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count()));
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Reclaims every pointer on every retired list. No other thread
+		may be using the owning container at this point.
+    ********************************************************************/
+	void Drain()
+	{
+		std::vector<RetiredPointer> remaining;
+		domain.AdoptOrphans(remaining);
+		domain.ForEachRecord([&remaining](HazardDomain::Record* record)
+		{
+			remaining.insert(remaining.end(), record->retired.begin(), record->retired.end());
+			record->retired.clear();
+		});
+		for(RetiredPointer const& retired : remaining)
+			retired.Reclaim();
+		unreclaimed.store(0, std::memory_order_relaxed);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of pointers retired but not yet reclaimed.
+
+	  \return
+	  	The # of pointers waiting on a scan.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return unreclaimed.load(std::memory_order_relaxed);
+	}
+
+#ifdef LFSV_STATS
+	/*!******************************************************************
+      \brief
+        Sums every thread's retire and scan counters.
+
+	  \return
+	  	The policy's retired pointers and scans.
+    ********************************************************************/
+	ReclaimStats Stats() const
+	{
+		ReclaimStats result = SumReclaim(stats, Unreclaimed());
+		result.hazards = domain.LiveHazards();
+		return result;
+	}
+#endif
+};
+
+/**************************************************************************/
+/*!
+  \class SharedHazardReclaimer
+  \brief  
+    Reclamation policy built on one HazardDomain shared by every
+	container in the process. Each thread owns a single record of hazard
+	slots and a single retired list no matter how many containers it
+	touches, so a container costs a counter rather than a domain, and
+	one scan reclaims pointers retired by every container at once.
+
+	Each retired pointer is tagged with the reclaimer that retired it
+	and the function that reclaims it, so it is always handed back to
+	its own container. Guards from several containers may be alive on
+	one thread at the same time; the first takes slot 0 and the rest
+	share the slots left for pins.
+
+    Non-Core Operations Include:
+
+    -Protects a pointer for the span of a single operation (Guard).
+	-Protects a pointer for as long as a handle lives (Pin).
+	-Retires a pointer, scanning once enough have piled up.
+	-Reclaims every pointer this reclaimer retired.
+	-Returns the # of pointers retired but not yet reclaimed.
+
+*/
+/**************************************************************************/
+class SharedHazardReclaimer
+{
+	/*!
+	  \struct Entry
+	  \brief
+	    A retired pointer, with its reclaim function, and the reclaimer
+	    that retired it.
+	*/
+	struct Entry
+	{
+		RetiredPointer retired;       // The retired pointer and its reclaim function
+		SharedHazardReclaimer* owner; // The reclaimer that retired it
+
+		/*!******************************************************************
+		  \brief
+			Reclaims the pointer and counts it off of its owner.
+		********************************************************************/
+		void Reclaim()
+		{
+			retired.Reclaim();
+			owner->unreclaimed.fetch_sub(1, std::memory_order_relaxed);
+		}
+	};
+
+	/*!
+	  \struct Record
+	  \brief
+	    One thread's retired list. Entries never move from one record
+	    to another; a record left behind by an exited thread keeps its
+	    entries until another thread claims it or scans it. The mutex
+	    is only contended by those scans, and when a container is being
+	    destroyed and drains its entries out of every list. Padded out
+	    to whole cache lines.
+	*/
+	struct alignas(HazardDomain::cacheLine) Record
+	{
+		std::mutex mutex;                  // Guards retired against Drain()
+		std::vector<Entry> retired;        // Pointers retired but not yet reclaimed
+		std::vector<void*> hazards;        // Scratch space for this thread's scans
+		std::vector<Record*> idle;         // Scratch space for this thread's scans
+		std::atomic<bool> active{false};   // Whether a thread currently owns this record
+		Record* next = nullptr;            // Pointer to the next record in the list
+	};
+
+	/*!
+	  \struct Domain
+	  \brief
+	    The process-wide hazard slots and retired lists.
+	*/
+	struct Domain
+	{
+		HazardDomain hazards;                       // Every thread's hazard slots
+		std::atomic<Record*> records{nullptr};      // Every retired list ever created
+		std::atomic<std::size_t> liveHazards{0};    // # of non-null hazards seen by the latest scan
+		std::uint64_t id = ThreadSlots::Register(); // The domain's id within ThreadSlots
+	};
+
+	std::atomic<std::size_t> unreclaimed; // # of pointers retired but not yet reclaimed
+#ifdef LFSV_STATS
+	StatBlocks<ReclaimCounters> stats;    // Per-thread retire and scan counters
+#endif
+
+	/*!******************************************************************
+      \brief
+        Returns the process-wide domain. It is never destroyed, so
+		threads exiting during static destruction can still hand their
+		records back.
+
+	  \return
+	  	The domain.
+    ********************************************************************/
+	static Domain& Shared()
+	{
+		static Domain* domain = new Domain();
+		return *domain;
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands a record back to the domain when the owning thread exits.
+		Its entries stay behind, to be reclaimed by other threads' scans.
+
+	  \param record
+	  	The record to release.
+    ********************************************************************/
+	static void OnThreadExit(void*, void* record)
+	{
+		Record* exiting = static_cast<Record*>(record);
+		{
+			std::lock_guard<std::mutex> lock(exiting->mutex);
+			exiting->hazards.clear();
+			exiting->hazards.shrink_to_fit();
+			exiting->idle.clear();
+			exiting->idle.shrink_to_fit();
+		}
+		exiting->active.store(false);
+	}
+
+	/*!******************************************************************
+      \brief
+        Reclaims every entry of a retired list that is not named in a
+		sorted snapshot of the hazards.
+
+	  \param retiredList
+	  	The list to scrub; its record's mutex must be held.
+
+	  \param activePointers
+	  	The sorted hazards.
+
+	  \return
+	  	The # of pointers reclaimed.
+    ********************************************************************/
+	static std::size_t Sweep(std::vector<Entry>& retiredList, std::vector<void*> const& activePointers)
+	{
+		std::size_t before = retiredList.size();
+		std::size_t i = 0;
+		while(i < retiredList.size())
+		{
+			if(std::binary_search(activePointers.begin(), activePointers.end(), retiredList[i].retired.Get()))
+				++i;
+			else
+			{
+				retiredList[i].Reclaim();
+				retiredList[i] = retiredList.back();
+				retiredList.pop_back();
+			}
+		}
+		return before - retiredList.size();
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's retired list, claiming one the
+		first time this thread retires a pointer.
+
+	  \return
+	  	The calling thread's record.
+    ********************************************************************/
+	static Record* Local()
+	{
+		Domain& domain = Shared();
+		void* found = ThreadSlots::Find(domain.id);
+		if(found)
+			return static_cast<Record*>(found);
+
+		// Try to reuse a record left behind by an exited thread
+		Record* record = domain.records.load();
+		for(; record != nullptr; record = record->next)
+		{
+			bool f = false;
+			if(!record->active.load() && record->active.compare_exchange_strong(f, true))
+				break;
+		}
+
+		if(record == nullptr)
+		{
+			record = new Record();
+			record->active.store(true);
+
+			Record* oldRecord = nullptr;
+			do
+			{
+				oldRecord = domain.records.load();
+				record->next = oldRecord;
+			} while (!domain.records.compare_exchange_weak(oldRecord, record));
+		}
+
+		if(!ThreadSlots::Exiting())
+			ThreadSlots::Add(domain.id, record, &SharedHazardReclaimer::OnThreadExit, &domain);
+		return record;
+	}
+
+	/*!******************************************************************
+      \brief
+        Scrub through a record's retired list, and those of records left
+		behind by exited threads, and reclaim every pointer that no
+		thread in the process is protecting, whichever container retired
+		it. Must be called with the record's mutex held.
+
+	  \param record
+	  	The record whose retired list should be scrubbed.
+
+	  \return
+	  	The # of pointers reclaimed.
+    ********************************************************************/
+	static std::size_t Scan(Record* record)
+	{
+		Domain& domain = Shared();
+		std::vector<void*>& activePointers = record->hazards;
+		std::vector<Record*>& idle = record->idle;
+
+		// Lock the left-behind records before collecting, so every entry
+		// swept was retired before the hazards were read
+		idle.clear();
+		for(Record* other = domain.records.load(); other != nullptr; other = other->next)
+		{
+			if(other->active.load() || !other->mutex.try_lock())
+				continue;
+			if(other->active.load() || other->retired.empty())
+				other->mutex.unlock();
+			else
+				idle.push_back(other);
+		}
+
+		activePointers.clear();
+		domain.hazards.Collect(activePointers);
+		std::sort(activePointers.begin(), activePointers.end());
+		domain.liveHazards.store(activePointers.size(), std::memory_order_relaxed);
+
+		std::size_t reclaimed = Sweep(record->retired, activePointers);
+		for(Record* other : idle)
+		{
+			reclaimed += Sweep(other->retired, activePointers);
+			other->mutex.unlock();
+		}
+		return reclaimed;
+	}
+
+	public:
+
+	/*!
+	  \class Guard
+	  \brief
+	    Protects one pointer at a time for the span of a single
+	    operation. Uses slot 0 of the calling thread's record, or a
+	    slot reserved with HoldSlot() if another container's guard on
+	    this thread already holds slot 0.
+	*/
+	class Guard
+	{
+		HazardDomain::Record* record; // The calling thread's hazard record
+		unsigned slot;                // The slot within the record this guard uses
+
+		public:
+
+		explicit Guard(SharedHazardReclaimer&) : record(Shared().hazards.Local()), slot(0)
+		{
+			if(record->heldSlots & 1u)
+				slot = record->HoldSlot();
+			else
+				record->heldSlots |= 1u;
+		}
+
+		~Guard()
+		{
+			record->DropSlot(slot);
+		}
+
+		Guard(Guard const&) = delete;
+		Guard& operator=(Guard const&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Protects the pointer currently held by an atomic source,
+			replacing whatever this guard protected before.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The protected pointer; safe to read until Clear().
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			return record->Protect(source, slot);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Stops protecting the current pointer.
+		********************************************************************/
+		void Clear()
+		{
+			record->Clear(slot);
+		}
+	};
+
+	/*!
+	  \class Pin
+	  \brief
+	    Protects one pointer for as long as the handle lives, using a
+	    slot reserved with HoldSlot(). Must be destroyed on the thread
+	    that created it.
+	*/
+	class Pin
+	{
+		HazardDomain::Record* record; // The hazard record holding the pin
+		unsigned slot;                // The slot within the record holding the pin
+
+		public:
+
+		explicit Pin(SharedHazardReclaimer&)
+			: record(Shared().hazards.Local()), slot(record->HoldSlot())
+		{}
+
+		Pin(Pin&& other) : record(other.record), slot(other.slot)
+		{
+			other.record = nullptr;
+		}
+
+		~Pin()
+		{
+			if(record)
+				record->DropSlot(slot);
+		}
+
+		Pin(Pin const&) = delete;
+		Pin& operator=(Pin const&) = delete;
+		Pin& operator=(Pin&&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Protects the pointer currently held by an atomic source.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The protected pointer; safe to read until the pin is destroyed.
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			return record->Protect(source, slot);
+		}
+	};
+
+	/*!******************************************************************
+      \brief
+        Constructor for the SharedHazardReclaimer class.
+    ********************************************************************/
+	SharedHazardReclaimer() : unreclaimed(0)
+	{}
+
+	SharedHazardReclaimer(SharedHazardReclaimer const&) = delete;
+	SharedHazardReclaimer& operator=(SharedHazardReclaimer const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Place a pointer into the calling thread's retired list, and scan
+		that list once it has grown long enough. The list is shared by
+		every container, so the cost of a scan is spread across all of
+		them.
+
+	  \param pointer
+	  	The pointer that has just been unlinked.
+
+	  \param reclaim
+	  	Called with the pointer once it is safe to reclaim. Kept with the
+		pointer (see RetiredPointer). It may run on any thread that
+		scans, and must not retire.
+    ********************************************************************/
+	template <typename Reclaim>
+	void Retire(void* pointer, Reclaim reclaim)
+	{
+		Entry entry = { RetiredPointer(pointer, reclaim), this };
+
+		Record* record = Local();
+		std::lock_guard<std::mutex> lock(record->mutex);
+		record->retired.push_back(entry);
+		unreclaimed.fetch_add(1, std::memory_order_relaxed);
+		LFSV_STAT(ReclaimCounters* counters = stats.Local());
+		LFSV_STAT(CountRetire(counters, record->retired.size()));
+
+		std::size_t hazardCount = Shared().liveHazards.load(std::memory_order_relaxed);
+		if(record->retired.size() >= std::max<std::size_t>(scanSize, scanFactor * hazardCount))
+		{
+			LFSV_STAT(auto start = std::chrono::steady_clock::now());
+			LFSV_TRACE(Trace(TraceEvent::ScanBegin));
+			std::size_t reclaimed = Scan(record);
+			LFSV_TRACE(Trace(TraceEvent::ScanEnd, reclaimed));
+			(void)reclaimed;
+			LFSV_STAT(Bump(counters->scans));
+			LFSV_STAT(Bump(counters->scanNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count()));
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Reclaims every pointer this reclaimer retired, taking them out
+		of every thread's retired list. No other
+		thread may be using the owning container at this point; other
+		containers may carry on.
+    ********************************************************************/
+	void Drain()
+	{
+		Domain& domain = Shared();
+		std::vector<RetiredPointer> remaining;
+		auto take = [this, &remaining](std::vector<Entry>& entries)
+		{
+			std::size_t kept = 0;
+			for(Entry& entry : entries)
+			{
+				if(entry.owner == this)
+					remaining.push_back(entry.retired);
+				else
+					entries[kept++] = entry;
+			}
+			entries.erase(entries.begin() + kept, entries.end());
+		};
+
+		for(Record* record = domain.records.load(); record != nullptr; record = record->next)
+		{
+			std::lock_guard<std::mutex> lock(record->mutex);
+			take(record->retired);
+		}
+
+		for(RetiredPointer const& retired : remaining)
+			retired.Reclaim();
+		unreclaimed.store(0, std::memory_order_relaxed);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of pointers retired but not yet reclaimed.
+
+	  \return
+	  	The # of pointers waiting on a scan.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return unreclaimed.load(std::memory_order_relaxed);
+	}
+
+#ifdef LFSV_STATS
+	/*!******************************************************************
+      \brief
+        Sums every thread's retire and scan counters. Scans are counted
+		against the container whose retire triggered them.
+
+	  \return
+	  	The policy's retired pointers and scans.
+    ********************************************************************/
+	ReclaimStats Stats() const
+	{
+		ReclaimStats result = SumReclaim(stats, Unreclaimed());
+		result.hazards = Shared().liveHazards.load(std::memory_order_relaxed);
+		return result;
+	}
+#endif
+};
+
+/**************************************************************************/
+/*!
+  \class EpochReclaimer
+  \brief  
+    Reclamation policy built on a global epoch counter. A reader only
+	announces the epoch it entered in and clears it when done, so a
+	protected read is a plain load. A pointer retired in epoch e may be
+	reclaimed once the epoch reaches e + 2, and the epoch only advances
+	once every thread inside a critical section has announced the
+	current one.
+
+	The trade-off: one stalled or long-pinned reader holds back every
+	retired pointer in the container, not just the one it is reading,
+	so peak unreclaimed memory is higher than with hazard pointers.
+
+    Non-Core Operations Include:
+
+    -Enters a critical section for the span of a single operation (Guard).
+	-Enters a critical section for as long as a handle lives (Pin).
+	-Retires a pointer, trying to advance the epoch once enough pile up.
+	-Reclaims every retired pointer once no other thread is running.
+	-Returns the # of pointers retired but not yet reclaimed.
+
+*/
+/**************************************************************************/
+class EpochReclaimer
+{
+	static const std::uint64_t idle = 0;   // Announced by a thread outside any critical section
+	static const unsigned batchSize = 64;  // Minimum # of pointers to collect before advancing
+
+	typedef std::pair<RetiredPointer, std::uint64_t> Retired; // A retired pointer and its epoch
+
+	/*!
+	  \struct Record
+	  \brief
+	    One thread's announced epoch and retired list. Padded out to
+	    whole cache lines.
+	*/
+	struct alignas(HazardDomain::cacheLine) Record
+	{
+		std::atomic<std::uint64_t> announced{idle}; // Epoch this thread entered in, or idle
+		unsigned depth = 0;                          // # of nested guards and pins; owner only
+		std::vector<Retired> retired;                // Pointers retired but not yet reclaimed
+		std::size_t threshold = batchSize;           // Retired list length that triggers a collect
+		std::atomic<bool> active{false};             // Whether a thread currently owns this record
+		Record* next = nullptr;                      // Pointer to the next record in the list
+	};
+
+	std::atomic<std::uint64_t> epoch;     // The global epoch
+	std::atomic<Record*> records;         // Every record created for this reclaimer
+	std::atomic<std::size_t> unreclaimed; // # of pointers retired but not yet reclaimed
+	std::uint64_t id;                     // This reclaimer's id within ThreadSlots
+
+	std::mutex orphanMutex;               // Guards orphans; cold paths only
+	std::vector<Retired> orphans;         // Retired pointers left behind by exited threads
+	std::atomic<bool> hasOrphans;         // Whether orphans is non-empty
+#ifdef LFSV_STATS
+	StatBlocks<ReclaimCounters> stats;    // Per-thread retire and collect counters
+#endif
+
+	/*!******************************************************************
+      \brief
+        Hands a record back to its reclaimer when the owning thread
+		exits. Anything still on its retired list moves to the orphans.
+
+	  \param owner
+	  	The reclaimer the record belongs to.
+
+	  \param record
+	  	The record to release.
+    ********************************************************************/
+	static void OnThreadExit(void* owner, void* record)
+	{
+		EpochReclaimer* reclaimer = static_cast<EpochReclaimer*>(owner);
+		Record* local = static_cast<Record*>(record);
+
+		local->depth = 0;
+		local->announced.store(idle);
+		if(!local->retired.empty())
+		{
+			std::lock_guard<std::mutex> lock(reclaimer->orphanMutex);
+			reclaimer->orphans.insert(reclaimer->orphans.end(), local->retired.begin(), local->retired.end());
+			reclaimer->hasOrphans.store(true);
+		}
+		local->retired.clear();
+		local->retired.shrink_to_fit();
+		local->threshold = batchSize;
+		local->active.store(false);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's record, claiming one the first time
+		this thread touches the reclaimer.
+
+	  \return
+	  	The calling thread's record.
+    ********************************************************************/
+	Record* Local()
+	{
+		void* found = ThreadSlots::Find(id);
+		if(found)
+			return static_cast<Record*>(found);
+
+		// Try to reuse a record left behind by an exited thread
+		Record* record = records.load();
+		for(; record != nullptr; record = record->next)
+		{
+			bool f = false;
+			if(!record->active.load() && record->active.compare_exchange_strong(f, true))
+				break;
+		}
+
+		if(record == nullptr)
+		{
+			record = new Record();
+			record->active.store(true);
+
+			Record* oldRecord = nullptr;
+			do
+			{
+				oldRecord = records.load();
+				record->next = oldRecord;
+			} while (!records.compare_exchange_weak(oldRecord, record));
+		}
+
+		if(!ThreadSlots::Exiting())
+			ThreadSlots::Add(id, record, &EpochReclaimer::OnThreadExit, this);
+		return record;
+	}
+
+	/*!******************************************************************
+      \brief
+        Enters a critical section. The announcement is re-checked against
+		the global epoch, so a thread delayed between reading the epoch
+		and announcing it never announces one that has already passed.
+
+	  \param record
+	  	The calling thread's record.
+    ********************************************************************/
+	void Enter(Record* record)
+	{
+		if(record->depth++ != 0)
+			return;
+
+		std::uint64_t current = epoch.load();
+		for(;;)
+		{
+			record->announced.store(current);
+			std::uint64_t validated = epoch.load();
+			if(validated == current)
+				return;
+			current = validated;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Leaves a critical section.
+
+	  \param record
+	  	The calling thread's record.
+    ********************************************************************/
+	void Exit(Record* record)
+	{
+		if(--record->depth == 0)
+			record->announced.store(idle, std::memory_order_release);
+	}
+
+	/*!******************************************************************
+      \brief
+        Advances the global epoch if every thread inside a critical
+		section has announced the current one.
+    ********************************************************************/
+	void TryAdvance()
+	{
+		std::uint64_t current = epoch.load();
+		for(Record* record = records.load(); record != nullptr; record = record->next)
+		{
+			std::uint64_t announced = record->announced.load();
+			if(announced != idle && announced != current)
+				return;
+		}
+		epoch.compare_exchange_strong(current, current + 1);
+	}
+
+	/*!******************************************************************
+      \brief
+        Tries to advance the epoch, then reclaims every pointer on a
+		record's retired list (plus any orphans) that was retired at
+		least two epochs ago. The next collect waits for another batch
+		of retires, so each batch moves the epoch forward once.
+
+	  \param record
+	  	The record whose retired list should be collected.
+
+	  \return
+	  	The # of pointers reclaimed.
+    ********************************************************************/
+	std::size_t Collect(Record* record)
+	{
+		std::vector<Retired>& retiredList = record->retired;
+		std::size_t reclaimed = 0;
+
+		if(hasOrphans.load())
+		{
+			std::lock_guard<std::mutex> lock(orphanMutex);
+			retiredList.insert(retiredList.end(), orphans.begin(), orphans.end());
+			orphans.clear();
+			hasOrphans.store(false);
+		}
+
+		TryAdvance();
+		std::uint64_t safe = epoch.load();
+
+		std::size_t i = 0;
+		while(i < retiredList.size())
+		{
+			if(retiredList[i].second + 2 > safe)
+				++i;
+			else
+			{
+				unreclaimed.fetch_sub(1, std::memory_order_relaxed);
+				retiredList[i].first.Reclaim();
+				retiredList[i] = retiredList.back();
+				retiredList.pop_back();
+				++reclaimed;
+			}
+		}
+
+		record->threshold = retiredList.size() + batchSize;
+		return reclaimed;
+	}
+
+	public:
+
+	/*!
+	  \class Guard
+	  \brief
+	    Keeps the calling thread inside a critical section from its
+	    first Protect() until Clear() or destruction.
+	*/
+	class Guard
+	{
+		EpochReclaimer& reclaimer; // The reclaimer this guard belongs to
+		Record* record;            // The calling thread's record
+		bool entered;              // Whether this guard is inside a critical section
+
+		public:
+
+		explicit Guard(EpochReclaimer& owner) : reclaimer(owner), record(owner.Local()), entered(false)
+		{}
+
+		~Guard()
+		{
+			Clear();
+		}
+
+		Guard(Guard const&) = delete;
+		Guard& operator=(Guard const&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Reads the pointer currently held by an atomic source, entering
+			a critical section first if needed.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The pointer; safe to read until Clear().
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			if(!entered)
+			{
+				reclaimer.Enter(record);
+				entered = true;
+			}
+			return source.load(std::memory_order_acquire);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Leaves the critical section, if inside one.
+		********************************************************************/
+		void Clear()
+		{
+			if(entered)
+			{
+				reclaimer.Exit(record);
+				entered = false;
+			}
+		}
+	};
+
+	/*!
+	  \class Pin
+	  \brief
+	    Keeps the calling thread inside a critical section for as long as
+	    the handle lives. Must be destroyed on the thread that created it.
+	*/
+	class Pin
+	{
+		EpochReclaimer* reclaimer; // The reclaimer this pin belongs to
+		Record* record;            // The calling thread's record
+
+		public:
+
+		explicit Pin(EpochReclaimer& owner) : reclaimer(&owner), record(owner.Local())
+		{
+			reclaimer->Enter(record);
+		}
+
+		Pin(Pin&& other) : reclaimer(other.reclaimer), record(other.record)
+		{
+			other.record = nullptr;
+		}
+
+		~Pin()
+		{
+			if(record)
+				reclaimer->Exit(record);
+		}
+
+		Pin(Pin const&) = delete;
+		Pin& operator=(Pin const&) = delete;
+		Pin& operator=(Pin&&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Reads the pointer currently held by an atomic source.
+
+		  \param source
+			The atomic pointer to read from.
+
+		  \return
+			The pointer; safe to read until the pin is destroyed.
+		********************************************************************/
+		template <typename U>
+		U* Protect(std::atomic<U*> const& source)
+		{
+			return source.load(std::memory_order_acquire);
+		}
+	};
+
+	/*!******************************************************************
+      \brief
+        Constructor for the EpochReclaimer class.
+    ********************************************************************/
+	EpochReclaimer() : epoch(idle + 1), records(nullptr), unreclaimed(0), id(ThreadSlots::Register()),
+		orphanMutex(), orphans(), hasOrphans(false)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the EpochReclaimer class. The owning container
+		must have drained every retired pointer by this point.
+    ********************************************************************/
+	~EpochReclaimer()
+	{
+		// No thread may hand a record back once this returns
+		ThreadSlots::Unregister(id);
+
+		Record* record = records.load();
+		while(record != nullptr)
+		{
+			Record* temp = record;
+			record = record->next;
+			delete temp;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Place a pointer into the calling thread's retired list, tagged
+		with the current epoch, and collect that list once it has grown
+		long enough.
+
+	  \param pointer
+	  	The pointer that has just been unlinked.
+
+	  \param reclaim
+	  	Called with the pointer once it is safe to reclaim. Kept with the
+		pointer (see RetiredPointer), so pointers of any type may share
+		the reclaimer.
+    ********************************************************************/
+	template <typename Reclaim>
+	void Retire(void* pointer, Reclaim reclaim)
+	{
+		Record* record = Local();
+		record->retired.emplace_back(RetiredPointer(pointer, reclaim), epoch.load());
+		unreclaimed.fetch_add(1, std::memory_order_relaxed);
+		LFSV_STAT(ReclaimCounters* counters = stats.Local());
+		LFSV_STAT(CountRetire(counters, record->retired.size()));
+
+		if(record->retired.size() >= record->threshold)
+		{
+			LFSV_STAT(auto start = std::chrono::steady_clock::now());
+			LFSV_TRACE(Trace(TraceEvent::ScanBegin));
+			std::size_t reclaimed = Collect(record);
+			LFSV_TRACE(Trace(TraceEvent::ScanEnd, reclaimed));
+			(void)reclaimed;
+			LFSV_STAT(Bump(counters->scans));
+			LFSV_STAT(Bump(counters->scanNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count()));
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Reclaims every pointer on every retired list. No other thread
+		may be using the owning container at this point.
+    ********************************************************************/
+	void Drain()
+	{
+		for(Record* record = records.load(); record != nullptr; record = record->next)
+		{
+			for(Retired const& retired : record->retired)
+				retired.first.Reclaim();
+			record->retired.clear();
+		}
+		for(Retired const& retired : orphans)
+			retired.first.Reclaim();
+		orphans.clear();
+		unreclaimed.store(0, std::memory_order_relaxed);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of pointers retired but not yet reclaimed.
+
+	  \return
+	  	The # of pointers waiting on the epoch to advance.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return unreclaimed.load(std::memory_order_relaxed);
+	}
+
+#ifdef LFSV_STATS
+	/*!******************************************************************
+      \brief
+        Sums every thread's retire and collect counters, and counts the
+		threads currently inside a critical section.
+
+	  \return
+	  	The policy's retired pointers and collections.
+    ********************************************************************/
+	ReclaimStats Stats() const
+	{
+		ReclaimStats result = SumReclaim(stats, Unreclaimed());
+		for(Record* record = records.load(); record != nullptr; record = record->next)
+			if(record->announced.load(std::memory_order_relaxed) != idle)
+				++result.hazards;
+		return result;
+	}
+#endif
+};
@@ -0,0 +1,333 @@
+/******************************************************************************/
+/*!
+\file   hazard_queue.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the definitions of the MSQueue and TreiberStack class
+	templates, a lock-free multi-producer multi-consumer queue and stack.
+	Both follow the same reclamation rules as the LFSV containers: a node
+	is unlinked with a single CAS, then retired to a reclamation policy
+	that frees it once no thread can still be reading it.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include "hazard.h"
+
+/**************************************************************************/
+/*!
+  \class MSQueue
+  \brief
+    A lock-free FIFO queue (Michael and Scott, 1996). The list always
+	starts with a dummy node; dequeuing moves the value out of the node
+	after it, which then becomes the new dummy, and retires the old one.
+	Enqueuers link a node onto the last node's next pointer, and any
+	thread that finds the tail lagging behind swings it forward.
+
+	A dequeue holds two hazards at once, the head and the node after it,
+	so it uses the reclaimer's Guard for one and a Pin for the other.
+
+    Non-Core Operations Include:
+
+    -Returns the # of dequeued nodes that have been retired but not yet
+	 reclaimed.
+
+*/
+/**************************************************************************/
+template <typename T, typename Reclaimer = HazardReclaimer>
+class MSQueue
+{
+	/*!
+	  \struct Node
+	  \brief
+	    One link of the queue. The value is built in place by Enqueue()
+	    and destroyed by the Dequeue() that takes it, so the dummy node
+	    never holds one.
+	*/
+	struct Node
+	{
+		std::atomic<Node*> next;                // The node enqueued after this one
+		alignas(T) unsigned char value[sizeof(T)]; // Storage for the value
+
+		Node() : next(nullptr)
+		{}
+
+		/*!******************************************************************
+		  \brief
+			Returns the value built in this node's storage.
+
+		  \return
+			The stored value.
+		********************************************************************/
+		T* Value()
+		{
+			return reinterpret_cast<T*>(value);
+		}
+	};
+
+	Reclaimer reclaimer;      // Reclaims dequeued nodes
+	std::atomic<Node*> head;  // The dummy node; its successor holds the front value
+	std::atomic<Node*> tail;  // The last node, or one lagging just behind it
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the MSQueue class.
+    ********************************************************************/
+	MSQueue() : reclaimer(), head(new Node()), tail(head.load())
+	{}
+
+	MSQueue(MSQueue const&) = delete;
+	MSQueue& operator=(MSQueue const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Destructor for the MSQueue class. No other thread may be using
+		the queue at this point.
+    ********************************************************************/
+	~MSQueue()
+	{
+		reclaimer.Drain();
+
+		Node* node = head.load();
+		Node* next = node->next.load();
+		delete node;
+		for(node = next; node != nullptr; node = next)
+		{
+			next = node->next.load();
+			node->Value()->~T();
+			delete node;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Add a value to the back of the queue.
+
+      \param v
+        The value to add.
+    ********************************************************************/
+	void Enqueue(T const& v)
+	{
+		Node* node = new Node();
+		new (node->value) T(v);
+
+		typename Reclaimer::Guard hp(reclaimer);
+		for(;;)
+		{
+			Node* last = hp.Protect(tail);
+			Node* next = last->next.load();
+			if(last != tail.load())
+				continue;
+
+			// Tail is lagging; help the enqueuer that got here first
+			if(next != nullptr)
+			{
+				tail.compare_exchange_strong(last, next);
+				continue;
+			}
+
+			if(last->next.compare_exchange_weak(next, node))
+			{
+				tail.compare_exchange_strong(last, node);
+				return;
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Take the value at the front of the queue.
+
+      \param v
+        Where to move the value to.
+
+      \return
+        Whether there was a value to take.
+    ********************************************************************/
+	bool Dequeue(T& v)
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		typename Reclaimer::Pin next_hp(reclaimer);
+		for(;;)
+		{
+			Node* first = hp.Protect(head);
+			Node* last = tail.load();
+			Node* next = next_hp.Protect(first->next);
+
+			// Next can only be retired after first is, so while first is
+			// still the head, next is safe to read
+			if(first != head.load())
+				continue;
+			if(next == nullptr)
+				return false;
+
+			// Tail is lagging; it must never be left behind the head
+			if(first == last)
+			{
+				tail.compare_exchange_strong(last, next);
+				continue;
+			}
+
+			if(head.compare_exchange_weak(first, next))
+			{
+				T* value = next->Value();
+				v = std::move(*value);
+				value->~T();
+
+				hp.Clear();
+				reclaimer.Retire(first, &DeleteObject<Node>);
+				return true;
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the # of dequeued nodes that have been retired but not
+        yet reclaimed.
+
+      \return
+        The # of nodes waiting on the reclaimer.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return reclaimer.Unreclaimed();
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class TreiberStack
+  \brief
+    A lock-free LIFO stack (Treiber, 1986). Pushes and pops swing the
+	top pointer with a single CAS. A popper protects the top node before
+	reading its next pointer, and popped nodes are retired rather than
+	freed, so a node can never be reused while another popper still
+	compares against it (the ABA problem).
+
+    Non-Core Operations Include:
+
+    -Returns the # of popped nodes that have been retired but not yet
+	 reclaimed.
+
+*/
+/**************************************************************************/
+template <typename T, typename Reclaimer = HazardReclaimer>
+class TreiberStack
+{
+	/*!
+	  \struct Node
+	  \brief
+	    One link of the stack. Immutable once pushed.
+	*/
+	struct Node
+	{
+		T value;    // The pushed value
+		Node* next; // The node below this one
+
+		explicit Node(T const& v) : value(v), next(nullptr)
+		{}
+	};
+
+	Reclaimer reclaimer;     // Reclaims popped nodes
+	std::atomic<Node*> top;  // The most recently pushed node
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the TreiberStack class.
+    ********************************************************************/
+	TreiberStack() : reclaimer(), top(nullptr)
+	{}
+
+	TreiberStack(TreiberStack const&) = delete;
+	TreiberStack& operator=(TreiberStack const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Destructor for the TreiberStack class. No other thread may be
+		using the stack at this point.
+    ********************************************************************/
+	~TreiberStack()
+	{
+		reclaimer.Drain();
+
+		Node* node = top.load();
+		while(node != nullptr)
+		{
+			Node* temp = node;
+			node = node->next;
+			delete temp;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Add a value to the top of the stack.
+
+      \param v
+        The value to add.
+    ********************************************************************/
+	void Push(T const& v)
+	{
+		Node* node = new Node(v);
+		Node* old = top.load();
+		do {
+			node->next = old;
+		} while(!top.compare_exchange_weak(old, node));
+	}
+
+	/*!******************************************************************
+      \brief
+        Take the value at the top of the stack.
+
+      \param v
+        Where to move the value to.
+
+      \return
+        Whether there was a value to take.
+    ********************************************************************/
+	bool Pop(T& v)
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		for(;;)
+		{
+			Node* old = hp.Protect(top);
+			if(old == nullptr)
+				return false;
+
+			if(top.compare_exchange_weak(old, old->next))
+			{
+				v = std::move(old->value);
+
+				hp.Clear();
+				reclaimer.Retire(old, &DeleteObject<Node>);
+				return true;
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the # of popped nodes that have been retired but not yet
+        reclaimed.
+
+      \return
+        The # of nodes waiting on the reclaimer.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return reclaimer.Unreclaimed();
+	}
+};
@@ -24,531 +24,2869 @@ vector container by using the hazard pointers concept.
 */
 /******************************************************************************/
 
+#pragma once
 #include <iostream>  // std::cout
 #include <atomic>    // std::atomic
 #include <thread>    // std::thread
 #include <vector>    // std::vector
-#include <deque>     // std::deque
 #include <mutex>     // std::mutex
-#include <algorithm> // std::find, std::sort, std::binary_search
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <cstddef>   // offsetof
+#include <new>       // std::bad_alloc
+#include <stdexcept> // std::length_error
+#include <unordered_map> // std::unordered_map
+#include <unordered_set> // std::unordered_set
+#include <algorithm> // std::find, std::sort, std::binary_search, std::merge
+#include <iterator>  // std::back_inserter
+#include <memory>    // std::allocator, std::allocator_traits
+#include <functional> // std::less
+#include <type_traits> // std::is_trivially_copyable
+#include <cstring>   // std::memcpy, std::memmove
+#include <utility>   // std::pair
+#include <chrono>    // std::chrono::steady_clock
+#include <condition_variable> // std::condition_variable
+#include <cstdio>    // std::fopen, std::fwrite, std::rename
+#include <string>    // std::string
+#include <cmath>     // std::ceil
+#include <exception> // std::exception_ptr
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, fsync, getpid
+#include <cerrno>     // errno, EEXIST
+#endif
+
+#include "hazard.h"
+
+/*!
+  \struct LFSVStats
+  \brief
+    A snapshot of every counter kept by an LFSV, aggregated across
+	threads when requested.
+*/
+struct LFSVStats
+{
+	bool enabled = false;           // Whether the counters were compiled in
+	std::uint64_t inserts = 0;      // # of values published by Insert() or InsertBatch()
+	std::uint64_t casFailures = 0;  // # of failed publish attempts
+	std::uint64_t erased = 0;       // # of values removed by the Erase family
+	std::uint64_t discarded = 0;    // # of copies thrown away because the data changed
+	ReclaimStats reclaim;           // Retired pointers and scans
+	BankStats bank;                 // Memory bank occupancy
+};
 
 /**************************************************************************/
 /*!
-  \class MemoryBank
+  \class BufferPool
   \brief  
-    A memory manager for std::vector<int> objects.
+    Recycles the element arrays behind SortedBuffers, keeping their
+	capacity. Arrays are bucketed by power-of-two size class, and each
+	thread keeps a small stack of free arrays per class. Writers retire
+	and reclaim their own versions, so under steady load an array freed
+	by a scan is handed straight to that thread's next copy and the
+	global heap is never touched.
+
+	Large arrays are capped by count rather than by class: a thread keeps
+	at most largeDepth arrays of largeBytes or more in all, so a big
+	container costs each writer at most a couple of spare copies. The
+	per-class stacks are only allocated once a thread frees an array of
+	that class, keeping an idle thread's cache to a few hundred bytes.
 
     Non-Core Operations Include:
 
-    -Returns a pointer to a "new" std::vector<int> object.
-    -Stores a std::vector<int> pointer back into the available list.
+    -Takes an array able to hold at least a given # of values.
+	-Gives an array back to the calling thread's cache.
 
 */
 /**************************************************************************/
-class MemoryBank 
+template <typename T, typename Allocator = std::allocator<T>>
+class BufferPool
 {
-    std::deque<std::vector<int>*> pointers; // total list of vector pointers
-    std::mutex mut;                         // used to secure all necessary operations
+	typedef std::allocator_traits<Allocator> Traits;
+
+	static const std::size_t minCapacity = 8;        // Capacity of the smallest size class
+	static const unsigned classes = 40;              // # of size classes; each doubles the last
+	static const unsigned depth = 16;                // # of free arrays a thread may hold per small class
+	static const std::size_t largeBytes = 1u << 18;  // Size from which an array counts as large
+	static const unsigned largeDepth = 2;            // # of free large arrays a thread may hold in all
+
+	/*!
+	  \struct Cache
+	  \brief
+	    One thread's stacks of free arrays, one per size class, each
+	    allocated on first use.
+	*/
+	struct Cache
+	{
+		T** arrays[classes] = {};         // Free arrays, by size class
+		unsigned counts[classes] = {};    // # of free arrays held per size class
+		unsigned large = 0;               // # of free large arrays held across every class
+		std::atomic<bool> active{false};  // Whether a thread currently owns this cache
+		Cache* next = nullptr;            // Pointer to the next cache owned by the pool
 
-    public:
+		~Cache()
+		{
+			for(unsigned c = 0; c < classes; ++c)
+				delete[] arrays[c];
+		}
+	};
 
-    /*!******************************************************************
+	/*!******************************************************************
       \brief
-        Constructor for the MemoryBank class.
+        Checks whether arrays of a size class count as large.
+
+	  \param c
+	  	The size class.
+
+	  \return
+	  	Whether the class's arrays take largeBytes or more.
     ********************************************************************/
-    MemoryBank() : pointers(6000)
-    {
-        // Allocate space for each pointer
-        for (int i = 0; i < 6000; i++)
-            pointers[i] = reinterpret_cast<std::vector<int>*>(new char[sizeof(std::vector<int>)]);
-    }
+	static bool IsLarge(unsigned c)
+	{
+		return (minCapacity << c) * sizeof(T) >= largeBytes;
+	}
 
-    /*!******************************************************************
+	Allocator alloc;            // Allocator for every array
+	std::atomic<Cache*> caches; // Every cache created for this pool
+	std::uint64_t id;           // This pool's id within ThreadSlots
+
+	/*!******************************************************************
       \brief
-        Destructor for the MemoryBank class.
+        Returns the size class able to hold a given # of values.
+
+	  \param n
+	  	The # of values.
+
+	  \return
+	  	The size class, or classes if n is too large to pool.
     ********************************************************************/
-    ~MemoryBank()
-    {
-        // Destroy all allocated space; all pointers should be returned by this point
-        for (auto &pointer : pointers)
-            delete[]reinterpret_cast<char*>(pointer);
-    }
+	static unsigned ClassOf(std::size_t n)
+	{
+		unsigned c = 0;
+		while(c < classes && (minCapacity << c) < n)
+			++c;
+		return c;
+	}
 
-    /*!******************************************************************
+	/*!******************************************************************
       \brief
-        Returns a pointer to a "new" std::vector<int> object.
+        Frees every array held by a cache.
 
-      \return
-        The new std::vector<int> pointer.
+	  \param cache
+	  	The cache to empty.
     ********************************************************************/
-    std::vector<int>* get()
-    {
-        std::lock_guard<std::mutex> lock(mut);
-        std::vector<int>* top = pointers[0];
-        pointers.pop_front();
-        return top;
-    }
+	void Empty(Cache* cache)
+	{
+		for(unsigned c = 0; c < classes; ++c)
+		{
+			for(unsigned i = 0; i < cache->counts[c]; ++i)
+				Traits::deallocate(alloc, cache->arrays[c][i], minCapacity << c);
+			cache->counts[c] = 0;
+		}
+		cache->large = 0;
+	}
 
-    /*!******************************************************************
+	/*!******************************************************************
       \brief
-        Stores a std::vector<int> pointer back into the available list.
+        Frees a cache's arrays and hands the cache back to its pool when
+		the owning thread exits.
+
+	  \param owner
+	  	The pool the cache belongs to.
 
-      \param pointer
-        The pointer that will be returned to the memory manager.
+	  \param record
+	  	The cache.
     ********************************************************************/
-    void store(std::vector<int>* pointer)
-    {
-        std::lock_guard<std::mutex> lock(mut);
-        pointers.push_back(pointer);
-    }
-};
+	static void OnThreadExit(void* owner, void* record)
+	{
+		Cache* cache = static_cast<Cache*>(record);
+		static_cast<BufferPool*>(owner)->Empty(cache);
+		cache->active.store(false);
+	}
 
-/**************************************************************************/
-/*!
-  \class HazardPointer
-  \brief  
-    A "hazard-pointer" wrapper for pointers in active use. All objects
-	of this class are actively managed within a central static linked
-	list.
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's cache, claiming one if needed.
 
-    Non-Core Operations Include:
+	  \return
+	  	The cache, or nullptr if this thread is already shutting down.
+    ********************************************************************/
+	Cache* LocalCache()
+	{
+		void* found = ThreadSlots::Find(id);
+		if(found)
+			return static_cast<Cache*>(found);
+		if(ThreadSlots::Exiting())
+			return nullptr;
+
+		// Try to reuse a cache left behind by an exited thread
+		Cache* cache = caches.load();
+		for(; cache != nullptr; cache = cache->next)
+		{
+			bool f = false;
+			if(!cache->active.load() && cache->active.compare_exchange_strong(f, true))
+				break;
+		}
 
-    -Clears all of the hazard pointers off of the main list.
-	-Provides a new hazard pointer to use.
-	-Scrubs the pointer data off of an existing hazard pointer.
+		if(cache == nullptr)
+		{
+			cache = new Cache();
+			cache->active.store(true);
 
-*/
-/**************************************************************************/
-class HazardPointer
-{
-	private:
-		std::atomic<bool> active;       // Used to check if the ptr can be reused
-		static std::atomic<int> length; // Length of main hp list
+			Cache* oldCache = nullptr;
+			do
+			{
+				oldCache = caches.load();
+				cache->next = oldCache;
+			} while (!caches.compare_exchange_weak(oldCache, cache));
+		}
+
+		ThreadSlots::Add(id, cache, &BufferPool::OnThreadExit, this);
+		return cache;
+	}
 
 	public:
-		void* pointer;                           // Pointer data this hp is protecting
-		HazardPointer* next;                     // Pointer to the next hp in the main list
-		static std::atomic<HazardPointer*> head; // Head to the main hp list
 
 	/*!******************************************************************
       \brief
-        Clears all of the hazard pointers off of the main list. This 
-		does not cleanup actual pointer data, so use ONLY after all 
-		other pointer-related operations are completed.
+        Constructor for the BufferPool class.
+
+	  \param allocator
+	  	The allocator to take new arrays from.
+    ********************************************************************/
+	explicit BufferPool(Allocator const& allocator = Allocator())
+		: alloc(allocator), caches(nullptr), id(ThreadSlots::Register())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the BufferPool class. Every array taken from the
+		pool must have been given back (or freed) by this point.
     ********************************************************************/
-	static void ClearAll()
+	~BufferPool()
 	{
-		HazardPointer* curr = head.load();
+		// No thread may hand a cache back once this returns
+		ThreadSlots::Unregister(id);
 
-		while(curr != nullptr)
+		Cache* cache = caches.load();
+		while(cache != nullptr)
 		{
-			HazardPointer* temp = curr;	
-			curr = curr->next;
+			Cache* temp = cache;
+			cache = cache->next;
+			Empty(temp);
 			delete temp;
 		}
-
-		head.store(nullptr);
 	}
 
+	BufferPool(BufferPool const&) = delete;
+	BufferPool& operator=(BufferPool const&) = delete;
+
 	/*!******************************************************************
       \brief
-        Provides a new hazard pointer to use. This will try to reuse
-		previously released hazard pointers, but it will willingly
-		create new ones if necessary.
+        Takes an array able to hold at least a given # of values, reusing
+		a free one of the same size class when this thread has one.
+
+	  \param n
+	  	The # of values the array must hold.
+
+	  \param capacity
+	  	Set to the # of values the array can actually hold.
 
 	  \return
-	  	The new hazard pointer to use.
+	  	The uninitialized array.
     ********************************************************************/
-	static HazardPointer* Get()
-	{	
-		HazardPointer* curr = head.load();
-		
-		// Try to find a retired, but not yet deleted pointer to reuse
-		for(; curr != nullptr; curr = curr->next)
+	T* Take(std::size_t n, std::size_t& capacity)
+	{
+		unsigned c = ClassOf(n);
+		if(c == classes)
 		{
-			// Temp variables
-			bool f = false;
-			bool t = true;
-
-			if(curr->active.load() || !(curr->active).compare_exchange_weak(f, t))
-				continue;
-			
-			return curr;
+			capacity = n;
+			return Traits::allocate(alloc, n);
 		}
 
-		// Need to add another pointer to the list:
-		// First, increment the internal counter
-		int oldLength;
-		do
-		{
-			oldLength = length.load();
-		} while (!(length).compare_exchange_weak(oldLength, oldLength + 1));
-		
-
-		// Create the new pointer
-		HazardPointer* newPointer = new HazardPointer();
-		newPointer->active.store(true);
-		newPointer->pointer = nullptr;
-
-		// Add the new pointer to the list
-		HazardPointer* oldPointer = nullptr;
-		do
+		capacity = minCapacity << c;
+		Cache* cache = LocalCache();
+		if(cache != nullptr && cache->counts[c] != 0)
 		{
-			oldPointer = head.load();
-			newPointer->next = oldPointer;
-		} while (!(head).compare_exchange_weak(oldPointer, newPointer));
-
-		return newPointer;
+			cache->large -= IsLarge(c);
+			return cache->arrays[c][--cache->counts[c]];
+		}
+		return Traits::allocate(alloc, capacity);
 	}
 
 	/*!******************************************************************
       \brief
-        Scrubs the pointer data off of an existing hazard pointer.
+        Gives an array back, keeping it in this thread's cache if there
+		is room (in its class, and among large arrays if it is one) and
+		freeing it otherwise.
 
-	  \param oldPointer
-	  	The hazard pointer to be released.
+	  \param array
+	  	The array, with every value already destroyed.
+
+	  \param capacity
+	  	The capacity reported by Take() for this array.
     ********************************************************************/
-	static void Release(HazardPointer* oldPointer)
+	void Give(T* array, std::size_t capacity)
 	{
-		oldPointer->pointer = nullptr;
-		oldPointer->active.store(false);
+		unsigned c = ClassOf(capacity);
+		Cache* cache = c == classes || (minCapacity << c) != capacity ? nullptr : LocalCache();
+		bool large = IsLarge(c);
+		if(cache == nullptr || cache->counts[c] == (large ? largeDepth : depth)
+		   || (large && cache->large == largeDepth))
+		{
+			Traits::deallocate(alloc, array, capacity);
+			return;
+		}
+
+		if(cache->arrays[c] == nullptr)
+			cache->arrays[c] = new T*[large ? largeDepth : depth];
+		cache->large += large;
+		cache->arrays[c][cache->counts[c]++] = array;
 	}
 };
 
-// Interface to ensure proper destruction
 /**************************************************************************/
 /*!
-  \class RetiredList
+  \class SortedBuffer
   \brief  
-    A wrapper for each writer thread's std::vector<std::vector<int>*> 
-	retired list. Ensures proper destruction when thread_local variables
-	are discarded.
+    The storage behind one version of an LFSV's data: a contiguous array
+	of T allocated through Allocator, or taken from a BufferPool when one
+	is given. For trivially copyable T, copies and
+	shifts are done with std::memcpy/std::memmove, chosen at compile time;
+	other types are copied and moved element by element.
 
     Non-Core Operations Include:
 
-    -Interface for list.push_back().
-	-Interface for list.size().
-	-Interface for list.begin().
-	-Interface for list.end().
-	-Interface for list.back().
-	-Interface for list.pop_back().
+    -Return the number of values within the buffer.
+	-Access the values within the buffer.
+	-Make room for a given number of values.
+	-Destroy every value within the buffer.
+	-Replace the contents with a copy of another buffer plus one value.
+	-Append a value to the end of the buffer.
+	-Append a run of values to the end of the buffer.
+	-Insert a value at a given position, shifting the tail up.
+	-Borrow values it does not own, copying them on the first change.
 
 */
 /**************************************************************************/
-class RetiredList
+template <typename T, typename Allocator = std::allocator<T>>
+class SortedBuffer
 {
-	std::vector<std::vector<int>*> list;
+	typedef std::allocator_traits<Allocator> Traits;
+	typedef BufferPool<T, Allocator> Pool;
 
-	public:
+	static const bool trivial = std::is_trivially_copyable<T>::value; // Use the memcpy/memmove paths
 
-	// Needs to access LFSV's bank to return pointers upon destruction
-	static MemoryBank* bank; 
+	Allocator alloc;    // Allocator for the underlying array
+	Pool* pool;         // Pool to take arrays from and give them back to, if any
+	T* items;           // The underlying array
+	std::size_t count;  // # of values constructed within the array
+	std::size_t room;   // # of values the array can hold
 
 	/*!******************************************************************
       \brief
-        Constructor for the RetiredList class.
+        Gives the underlying array back to the pool, or frees it.
     ********************************************************************/
-	RetiredList() : list()
-	{}
+	void Deallocate()
+	{
+		if(!items || room == 0) // Nothing owned, or only borrowed
+			return;
+		if(pool)
+			pool->Give(items, room);
+		else
+			Traits::deallocate(alloc, items, room);
+	}
 
 	/*!******************************************************************
       \brief
-        Destructor for the RetiredList class. Returns all pointers in
-		the interal list to the main MemoryBank, clearing each pointer's
-		data if necessary.
+        Moves every value into a new array of a given capacity.
+
+	  \param newRoom
+	  	The capacity of the new array.
     ********************************************************************/
-	~RetiredList()
+	void Relocate(std::size_t newRoom)
 	{
-		std::vector<std::vector<int>*>::iterator iter = list.begin();
-		while(iter != list.end())
+		T* fresh = pool ? pool->Take(newRoom, newRoom) : Traits::allocate(alloc, newRoom);
+
+		if constexpr (trivial)
+		{
+			if(count != 0)
+				std::memcpy(static_cast<void*>(fresh), items, count * sizeof(T));
+		}
+		else
 		{
-			// "Delete" the retired pointer if need be
-			if(*iter != nullptr)
-				(*iter)->~vector(); // Deletion handled later by memory bank
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				Traits::construct(alloc, fresh + i, std::move(items[i]));
+				Traits::destroy(alloc, items + i);
+			}
+		}
 
-			bank->store(*iter);
+		Deallocate();
+		items = fresh;
+		room = newRoom;
+	}
 
-			if(&*iter != &list.back())
-				*iter = list.back();
-			list.pop_back();
-		}
+	public:
+
+	typedef T value_type;           // Required by std::back_inserter
+	typedef T const* const_iterator;
+
+	/*!******************************************************************
+      \brief
+        Constructor for the SortedBuffer class. Creates an empty buffer.
+
+	  \param allocator
+	  	The allocator to use for the underlying array.
+
+	  \param arrays
+	  	The pool to take arrays from, or nullptr to use the allocator
+		directly. Must use an allocator equal to this one.
+    ********************************************************************/
+	explicit SortedBuffer(Allocator const& allocator = Allocator(), Pool* arrays = nullptr)
+		: alloc(allocator), pool(arrays), items(nullptr), count(0), room(0)
+	{}
+
+	SortedBuffer(SortedBuffer const&) = delete;
+	SortedBuffer& operator=(SortedBuffer const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Destructor for the SortedBuffer class.
+    ********************************************************************/
+	~SortedBuffer()
+	{
+		clear();
+		Deallocate();
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.push_back().
+        Return the number of values within the buffer.
 
-	  \param p
-	  	Pointer to push onto the internal list.
+	  \return
+	  	The number of values.
     ********************************************************************/
-	void push_back(std::vector<int>* p)
+	std::size_t size() const
 	{
-		list.push_back(p);
+		return count;
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.size().
+        Return whether the buffer holds no values.
 
 	  \return
-	  	Size of the internal list.
+	  	Whether the buffer is empty.
     ********************************************************************/
-	unsigned size()
+	bool empty() const
 	{
-		return list.size();
+		return count == 0;
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.begin().
+        Return the number of values the buffer can hold without
+		reallocating.
 
 	  \return
-	  	Iterator at the front of the internal list.
+	  	The capacity of the buffer.
     ********************************************************************/
-	std::vector<std::vector<int>*>::iterator begin()
+	std::size_t capacity() const
 	{
-		return list.begin();
+		return room;
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.end().
+        Return a pointer to the first value within the buffer.
 
 	  \return
-	  	Iterator at the end of the internal list.
+	  	The pointer.
     ********************************************************************/
-	std::vector<std::vector<int>*>::iterator end()
+	T const* data() const
 	{
-		return list.end();
+		return items;
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.back().
+        Return an iterator to the first value within the buffer.
 
 	  \return
-	  	Reference to the last element of the internal list.
+	  	The iterator.
     ********************************************************************/
-	std::vector<int>*& back()
+	const_iterator begin() const
 	{
-		return list.back();
+		return items;
 	}
 
 	/*!******************************************************************
       \brief
-		Interface for list.pop_back().
+        Return an iterator past the last value within the buffer.
+
+	  \return
+	  	The iterator.
     ********************************************************************/
-	void pop_back()
+	const_iterator end() const
 	{
-		list.pop_back();
+		return items + count;
 	}
-};
 
-std::atomic<int> HazardPointer::length(0);               
-std::atomic<HazardPointer*> HazardPointer::head(nullptr);
-MemoryBank* RetiredList::bank(nullptr);
+	/*!******************************************************************
+      \brief
+        Return the value at a specific index within the buffer.
 
-thread_local RetiredList retiredList; // This thread's retired list
-const int scanSize = 10;              // # of pointers to collect before scanning
+	  \param pos
+	  	The index to read.
 
-/**************************************************************************/
-/*!
-  \class LFSV
-  \brief  
-    A lock-free implementation of an automatically-sorting vector. Sorts
-    elements from least to greatest.
+	  \return
+	  	The value at the index.
+    ********************************************************************/
+	T const& operator[](std::size_t pos) const
+	{
+		return items[pos];
+	}
 
-    Non-Core Operations Include:
+	/*!******************************************************************
+      \brief
+        Return the last value within the buffer.
 
-    -Insert a new value into the vector.
-    -Return the value at a specific index within the vector.
-	-Place an old/replaced vector into this thread's retired list.
-	-Scrub through the retired list to try to "delete" unused pointers.
+	  \return
+	  	The last value.
+    ********************************************************************/
+	T const& back() const
+	{
+		return items[count - 1];
+	}
 
-*/
-/**************************************************************************/
-class LFSV 
-{
-	MemoryBank bank;         			  // Handles all std::vector<int>-related memory creation/deletion
-    std::atomic<std::vector<int>*> pdata; // The current set of data representing the vector
-	
 	/*!******************************************************************
       \brief
-		Place an old/replaced vector into this thread's retired list.
+        Make room for a given number of values.
 
-	  \param oldPointer
-	  	The pointer to insert into the retired list.
+	  \param n
+	  	The # of values the buffer should be able to hold.
+    ********************************************************************/
+	void reserve(std::size_t n)
+	{
+		if(n > room)
+			Relocate(std::max(n, count));
+	}
+
+	/*!******************************************************************
+      \brief
+        Point the buffer at values it does not own, such as a read-only
+		file mapping, dropping whatever it held before. Borrowed values
+		are never written or freed; the first change copies them into an
+		array of the buffer's own.
+
+	  \param values
+	  	Pointer to the first (sorted) value to borrow.
+
+	  \param n
+	  	The # of values to borrow.
     ********************************************************************/
-	void Retire(std::vector<int>* oldPointer)
+	void borrow(T const* values, std::size_t n)
 	{
-		retiredList.push_back(oldPointer);
+		static_assert(std::is_trivially_copyable<T>::value, "SortedBuffer: only trivial values can be borrowed");
+
+		clear();
+		Deallocate();
+		items = const_cast<T*>(values);
+		count = n;
+		room = 0;
+	}
 
-		if(retiredList.size() >= scanSize)
-			Scan(HazardPointer::head.load());
+	/*!******************************************************************
+      \brief
+        Destroy every value within the buffer, keeping its capacity.
+    ********************************************************************/
+	void clear()
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+			for(std::size_t i = 0; i < count; ++i)
+				Traits::destroy(alloc, items + i);
+		count = 0;
 	}
 
 	/*!******************************************************************
       \brief
-		Scrub through the retired list to try to "delete" unused 
-		pointers.
+        Replace the contents with a copy of another buffer that has one
+		value inserted on the way: copies the prefix, writes the value,
+		then copies the suffix, so the tail is never shifted after the
+		copy. Reuses this buffer's array when it is large enough.
+
+	  \param other
+	  	The buffer to copy.
 
-	  \param head
-	  	The head of the main hazard pointer linked list.
+	  \param pos
+	  	The index the new value should end up at.
+
+	  \param v
+	  	The value to insert.
     ********************************************************************/
-	void Scan(HazardPointer* head)
+	void assign(SortedBuffer const& other, std::size_t pos, T const& v)
 	{
-		// Collect all still valid pointers
-		std::vector<void*> activePointers;
-		while(head != nullptr)
+		clear();
+		reserve(other.count + 1);
+
+		if constexpr (trivial)
 		{
-			void* pointer = head->pointer;
-			if(pointer != nullptr)
-				activePointers.push_back(pointer);
-			head = head->next;
+			if(pos != 0)
+				std::memcpy(static_cast<void*>(items), other.items, pos * sizeof(T));
+			std::memcpy(static_cast<void*>(items + pos), &v, sizeof(T));
+			if(other.count != pos)
+				std::memcpy(static_cast<void*>(items + pos + 1), other.items + pos,
+				            (other.count - pos) * sizeof(T));
 		}
-		
-		// Search through the thread's local retired list 
-		std::vector<std::vector<int>*>::iterator iter = retiredList.begin();
-		while(iter != retiredList.end())
+		else
 		{
-			// If the current retired pointer can't be found as an active hazard pointer....
-			if(std::find(activePointers.begin(), activePointers.end(), *iter) == activePointers.end())
-			{
-				// "Delete" the retired pointer
-				if(*iter != nullptr)
-					(*iter)->~vector(); // Deletion handled later by memory bank
-
-				bank.store(*iter);
-				
-				if(&*iter != &retiredList.back())
-					*iter = retiredList.back();
-				retiredList.pop_back();
-			}
-			else
-				++iter;
+			for(std::size_t i = 0; i < pos; ++i)
+				Traits::construct(alloc, items + i, other.items[i]);
+			Traits::construct(alloc, items + pos, v);
+			for(std::size_t i = pos; i < other.count; ++i)
+				Traits::construct(alloc, items + i + 1, other.items[i]);
 		}
+		count = other.count + 1;
 	}
 
-    public:
-
-    /*!******************************************************************
+	/*!******************************************************************
       \brief
-        Constructor for the LFSV class.
+        Append a value to the end of the buffer.
+
+	  \param v
+	  	The value to append.
     ********************************************************************/
-    LFSV() : bank(), pdata(new (bank.get()) std::vector<int>)
-    {
-		RetiredList::bank = &bank;
+	void push_back(T const& v)
+	{
+		if(count >= room)
+			Relocate(room ? room * 2 : count + 8);
+		Traits::construct(alloc, items + count, v);
+		++count;
 	}
 
-    /*!******************************************************************
+	/*!******************************************************************
       \brief
-        Destructor for the LFSV class.
-    ********************************************************************/
-    ~LFSV() 
-    { 
-        std::vector<int>* p = pdata.load();
-        p->~vector();
-        bank.store(p);
+        Append a run of values to the end of the buffer. The run must not
+		live within this buffer.
 
-		// Allocated hazard pointer objects must be taken care of
-		HazardPointer::ClearAll();
+	  \param first
+	  	Pointer to the first value of the run.
 
-		// Every remaining pointer in retired list should be sent to memory bank
-		Scan(HazardPointer::head.load()); 
-    }
+	  \param last
+	  	Pointer past the last value of the run.
+    ********************************************************************/
+	void append(T const* first, T const* last)
+	{
+		std::size_t n = static_cast<std::size_t>(last - first);
+		if(count + n > room)
+			Relocate(std::max(count + n, room * 2));
 
-    /*!******************************************************************
+		if constexpr (trivial)
+		{
+			if(n)
+				std::memcpy(static_cast<void*>(items + count), first, n * sizeof(T));
+		}
+		else
+			for(std::size_t i = 0; i < n; ++i)
+				Traits::construct(alloc, items + count + i, first[i]);
+		count += n;
+	}
+
+	/*!******************************************************************
       \brief
-        Insert a new value into the vector.
+        Insert a value at a given position, shifting the tail up by one.
 
-      \param v
-        Reference to the new value to insert into the vector.
+	  \param pos
+	  	The index the new value should end up at.
+
+	  \param v
+	  	The value to insert.
     ********************************************************************/
-    void Insert(int const& v) 
-    {      
-        std::vector<int>* pdata_new = nullptr; // Modified copy of vector data
-		std::vector<int>* pdata_old = nullptr; // Pure copy of vector data
-        std::vector<int>* last = nullptr;      // Used to check if insert needs to performed on new data
+	void insert(std::size_t pos, T const& v)
+	{
+		if(count >= room)
+			Relocate(room ? room * 2 : count + 8);
 
-		HazardPointer* hp = HazardPointer::Get();
+		if constexpr (trivial)
+		{
+			std::memmove(static_cast<void*>(items + pos + 1), items + pos, (count - pos) * sizeof(T));
+			std::memcpy(static_cast<void*>(items + pos), &v, sizeof(T));
+		}
+		else if(pos == count)
+			Traits::construct(alloc, items + count, v);
+		else
+		{
+			Traits::construct(alloc, items + count, std::move(items[count - 1]));
+			std::move_backward(items + pos, items + count - 1, items + count);
+			items[pos] = v;
+		}
+		++count;
+	}
+};
 
-        do {
-			// Store old pointer to ensure safe reading
-			do
-			{
-				pdata_old = pdata.load(); // Pull most recent copy
-				hp->pointer = pdata_old;  // Prepare pointer to be marked as a longer-term hazard
-			} while (!(this->pdata).compare_exchange_weak(pdata_old, pdata_old));
+const std::size_t searchWindow = 64; // # of values left for a linear count to finish a search
 
-            // If the insertion needs to be performed again,
-            if(last != pdata_old)
-            {
-                // Try to deference the "new" pointer from the previous loop
-                if(pdata_new)
-                {
-					pdata_new->~vector();
-					bank.store(pdata_new);
-					pdata_new = nullptr;
-                }
-                
-                // Pull new memory and make a new reference
-				pdata_new = new (bank.get()) std::vector<int>(*pdata_old);
-
-                // Insert new element and sort on the "new" local copy	
-				std::vector<int>::iterator b = pdata_new->begin();
-				std::vector<int>::iterator e = pdata_new->end();
-				if (b==e || v>=pdata_new->back())
-                    pdata_new->push_back(v); // first in empty or last element
-                else 
-                {
-                    for (; b!=e; ++b) 
-                    {
-                        if (*b >= v) 
-                        {
-                            pdata_new->insert(b, v);
-                            break;
-                        }
-                    }
-                }
+/*!******************************************************************
+  \brief
+    Counts how many of a run of ints are not greater than a key, without
+	branching on the comparison. Compilers vectorize this with whatever
+	the baseline instruction set offers.
 
-                last = pdata_old; // Update record of most recent data set
-            }
-        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+  \param values
+	Pointer to the first value of the run.
 
-        // Release the hazard pointer and retire the "old" pointer/data after it has been replaced
-		HazardPointer::Release(hp);
-		Retire(pdata_old);
-    }
+  \param n
+	The # of values within the run.
 
-    /*!******************************************************************
-      \brief
-        Return the value at a specific index within the vector.
+  \param key
+	The value to compare against.
 
-      \param pos
-        The index within the vector to pull a value from.
+  \return
+	The # of values not greater than key.
+********************************************************************/
+inline std::size_t CountNotGreaterScalar(int const* values, std::size_t n, int key)
+{
+	std::size_t count = 0;
+	for(std::size_t i = 0; i < n; ++i)
+		count += values[i] <= key;
+	return count;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // _mm256_cmpgt_epi32 and friends
+
+/*!******************************************************************
+  \brief
+    AVX2 version of CountNotGreaterScalar(): compares eight values per
+	instruction and counts the results with a movemask and popcount.
+	Only called once the CPU has been checked for AVX2 support.
+
+  \param values
+	Pointer to the first value of the run.
+
+  \param n
+	The # of values within the run.
+
+  \param key
+	The value to compare against.
+
+  \return
+	The # of values not greater than key.
+********************************************************************/
+__attribute__((target("avx2,popcnt")))
+inline std::size_t CountNotGreaterAvx2(int const* values, std::size_t n, int key)
+{
+	__m256i keys = _mm256_set1_epi32(key);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+	{
+		__m256i run = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values + i));
+		int greater = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(run, keys)));
+		count += 8 - static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(greater)));
+	}
+	return count + CountNotGreaterScalar(values + i, n - i, key);
+}
+#endif
+
+/*!******************************************************************
+  \brief
+    Picks the fastest CountNotGreater kernel the running CPU supports.
+	Detection only happens once per process.
+
+  \return
+	The kernel to use.
+********************************************************************/
+inline std::size_t (*CountNotGreaterKernel())(int const*, std::size_t, int)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	static std::size_t (*const kernel)(int const*, std::size_t, int) =
+		__builtin_cpu_supports("avx2") ? &CountNotGreaterAvx2 : &CountNotGreaterScalar;
+	return kernel;
+#else
+	return &CountNotGreaterScalar;
+#endif
+}
+
+/*!******************************************************************
+  \brief
+    Finds the first value within a sorted run that is greater than v, so
+	new values land after any equal ones. Halves the run without
+	branching on the comparison until searchWindow values remain. Plain
+	ints under std::less then finish with a compare-and-count kernel
+	chosen at runtime (AVX2 where available); everything else finishes
+	the same way it started.
+
+  \param first
+	Pointer to the first value of the run.
+
+  \param last
+	Pointer past the last value of the run.
+
+  \param v
+	The value to search for.
+
+  \param comp
+	The ordering of the run.
+
+  \return
+	Pointer to the first value greater than v, or last.
+********************************************************************/
+template <typename T, typename Compare>
+T const* FindUpperBound(T const* first, T const* last, T const& v, Compare const& comp)
+{
+	std::size_t length = static_cast<std::size_t>(last - first);
 
-      \return
-        The int value at the specified position within the vector.
-    ********************************************************************/
-    int operator[](int pos) 
-    {
-		std::vector<int>* pdata_old; // Pure copy of vector data
-        int ret_val;                 // The int value to be returned
+	if constexpr (std::is_same<T, int>::value && std::is_same<Compare, std::less<int>>::value)
+	{
+		while(length > searchWindow)
+		{
+			std::size_t half = length / 2;
+			first = comp(v, first[half]) ? first : first + half;
+			length -= half;
+		}
+		return first + CountNotGreaterKernel()(first, length, v);
+	}
+	else
+	{
+		if(length == 0)
+			return first;
 
-		HazardPointer* hp = HazardPointer::Get();
+		while(length > 1)
+		{
+			std::size_t half = length / 2;
+			first = comp(v, first[half]) ? first : first + half;
+			length -= half;
+		}
+		return first + !comp(v, *first);
+	}
+}
 
-        // Store old pointer in a hazard pointer to ensure safe reading
-        do
-        {
-            pdata_old = pdata.load();
-			hp->pointer = pdata_old;
-        } while (!(this->pdata).compare_exchange_weak(pdata_old, pdata_old));
+/*!
+  \struct ValueSum
+  \brief
+    The type SumRange() adds values up in: long long or unsigned long
+    long for integers, long double for floating point, so a sum of many
+    values does not overflow the value type itself. Values that are not
+    arithmetic cannot be summed, and get an empty placeholder.
+*/
+template <typename T, bool Arithmetic = std::is_arithmetic<T>::value>
+struct ValueSum
+{
+	struct type {};
+};
 
-		ret_val = (*pdata_old)[pos]; // Read value at given position
+template <typename T>
+struct ValueSum<T, true>
+{
+	typedef typename std::conditional<std::is_floating_point<T>::value, long double,
+		typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type type;
+};
 
-		HazardPointer::Release(hp);
+/*!******************************************************************
+  \brief
+    Returns the index the p-th percentile of n sorted values sits at,
+	by the nearest-rank method: the smallest index whose value is not
+	exceeded by p percent of the values.
 
-        return ret_val;
+  \param p
+	The percentile, clamped to [0, 100].
+
+  \param n
+	The # of values; must not be 0.
+
+  \return
+	The index.
+********************************************************************/
+inline std::size_t PercentileIndex(double p, std::size_t n)
+{
+	p = std::min(100.0, std::max(0.0, p));
+	std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(n)));
+	return rank == 0 ? 0 : std::min(rank, n) - 1;
+}
+
+const std::size_t sortGrain = 1 << 14; // Fewest values worth handing to a thread of their own
+
+/*!******************************************************************
+  \brief
+    Runs a number of tasks across a pool of threads. Each thread,
+	the calling one included, keeps claiming the next unclaimed task
+	until none are left.
+
+  \param tasks
+	The # of tasks.
+
+  \param threads
+	The most threads to run them on, counting the caller.
+
+  \param task
+	Called once with the index of every task.
+********************************************************************/
+template <typename Task>
+void ParallelFor(std::size_t tasks, unsigned threads, Task const& task)
+{
+	std::atomic<std::size_t> next(0);
+	auto work = [&next, tasks, &task]()
+	{
+		for(std::size_t i = next.fetch_add(1); i < tasks; i = next.fetch_add(1))
+			task(i);
+	};
+
+	std::vector<std::thread> pool;
+	for(unsigned t = 1; t < threads && t < tasks; ++t)
+		pool.emplace_back(work);
+	work();
+	for(std::thread& worker : pool)
+		worker.join();
+}
+
+/*!******************************************************************
+  \brief
+    Sorts values with a merge sort spread across a pool of threads.
+	Every thread sorts one run, then runs are merged in pairs, round by
+	round. Each merge is cut into pieces at evenly spaced values of its
+	left run (and the matching bound in its right run), so even the
+	last round keeps every thread busy.
+
+  \param values
+	The values to sort.
+
+  \param comp
+	The ordering to sort by.
+
+  \param threads
+	The # of threads to use, counting the caller; 0 means one per
+	hardware thread.
+********************************************************************/
+template <typename T, typename Compare>
+void ParallelSort(std::vector<T>& values, Compare const& comp, unsigned threads = 0)
+{
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::size_t n = values.size();
+	std::size_t runs = std::min<std::size_t>(threads, n / sortGrain);
+	if(runs <= 1)
+	{
+		std::sort(values.begin(), values.end(), comp);
+		return;
+	}
+
+	std::vector<std::size_t> bounds(runs + 1); // Start of each run, plus the end
+	for(std::size_t i = 0; i <= runs; ++i)
+		bounds[i] = n * i / runs;
+	ParallelFor(runs, threads, [&values, &bounds, &comp](std::size_t i)
+	{
+		std::sort(values.begin() + bounds[i], values.begin() + bounds[i + 1], comp);
+	});
+
+	std::vector<T> scratch(values); // Merges ping-pong between the two
+	std::vector<T>* from = &values;
+	std::vector<T>* to = &scratch;
+	while(bounds.size() > 2)
+	{
+		std::size_t pairs = (bounds.size() - 1) / 2;
+		std::size_t pieces = std::max<std::size_t>(1, threads / std::max<std::size_t>(pairs, 1));
+		std::size_t tasks = pairs * pieces + (bounds.size() - 1) % 2;
+
+		ParallelFor(tasks, threads, [&](std::size_t task)
+		{
+			T const* source = from->data();
+			T* target = to->data();
+
+			// A run without a partner this round is copied across
+			if(task == pairs * pieces)
+			{
+				std::size_t first = bounds[bounds.size() - 2];
+				std::copy(source + first, source + n, target + first);
+				return;
+			}
+
+			std::size_t pair = task / pieces;
+			std::size_t piece = task % pieces;
+			std::size_t leftFirst = bounds[2 * pair];
+			std::size_t rightFirst = bounds[2 * pair + 1];
+			std::size_t rightLast = bounds[2 * pair + 2];
+
+			// Left run cut evenly; right run cut where those values fall
+			auto cut = [&](std::size_t k, std::size_t& left, std::size_t& right)
+			{
+				left = leftFirst + (rightFirst - leftFirst) * k / pieces;
+				right = k == pieces ? rightLast : k == 0 ? rightFirst :
+					static_cast<std::size_t>(std::lower_bound(source + rightFirst, source + rightLast,
+						source[left], comp) - source);
+			};
+			std::size_t leftBegin, rightBegin, leftEnd, rightEnd;
+			cut(piece, leftBegin, rightBegin);
+			cut(piece + 1, leftEnd, rightEnd);
+
+			std::merge(source + leftBegin, source + leftEnd, source + rightBegin, source + rightEnd,
+			           target + leftFirst + (leftBegin - leftFirst) + (rightBegin - rightFirst), comp);
+		});
+
+		std::vector<std::size_t> merged;
+		for(std::size_t i = 0; i < bounds.size(); i += 2)
+			merged.push_back(bounds[i]);
+		if(merged.back() != n)
+			merged.push_back(n);
+		bounds.swap(merged);
+		std::swap(from, to);
+	}
+
+	if(from != &values)
+		values.swap(scratch);
+}
+
+/*!******************************************************************
+  \brief
+    How LFSV::Insert() publishes new values. CAS has every writer copy
+	and publish on its own; Combining has writers post their values and
+	lets a single combiner thread apply them together; Staged has writers
+	push their values onto a staging list that a background compactor
+	merges in periodically.
+********************************************************************/
+enum class WriteMode { CAS, Combining, Staged };
+
+/*!******************************************************************
+  \brief
+    What LFSV::operator[] sees of values still staged under
+	WriteMode::Staged. Merge folds them into the read without publishing
+	anything; Flush merges and publishes them first, as the compactor
+	would.
+********************************************************************/
+enum class ReadConsistency { Merge, Flush };
+
+/**************************************************************************/
+/*!
+  \struct StagedValue
+  \brief
+    One value pushed onto an LFSV's staging list. Each value is numbered
+	one past the value below it, so the list is always in descending
+	order, and a version of the data can record how much of the list it
+	already holds with a single number.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct StagedValue
+{
+	T value;                          // The staged value
+	std::uint64_t seq;                // One past the seq of the value below
+	std::atomic<StagedValue*> next;   // The value staged before this one, until trimmed
+
+	/*!******************************************************************
+      \brief
+        Constructor for the StagedValue struct.
+
+	  \param v
+	  	The value to stage.
+    ********************************************************************/
+	explicit StagedValue(T const& v) : value(v), seq(0), next(nullptr)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Deletes a trimmed run of the staging list.
+
+	  \param pointer
+	  	The first value of the run.
+    ********************************************************************/
+	static void DeleteRun(void* pointer)
+	{
+		StagedValue* node = static_cast<StagedValue*>(pointer);
+		while(node != nullptr)
+		{
+			StagedValue* temp = node;
+			node = node->next.load(std::memory_order_relaxed);
+			delete temp;
+		}
+	}
+};
+
+/**************************************************************************/
+/*!
+  \struct PublicationRecord
+  \brief
+    A slot a writer thread posts its value into while waiting for the
+	combiner to apply it. Records are kept in a per-LFSV linked list, and
+	each thread keeps the one it claims until it exits, so only a thread's
+	first combining insert walks the list. If the combiner throws while
+	applying a value, it hands the exception back through error.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct PublicationRecord
+{
+	std::atomic<bool> active{false};   // Whether a thread currently owns this slot
+	std::atomic<bool> pending{false};  // Whether value is waiting to be applied
+	T value;                           // The value posted by the owning thread
+	std::exception_ptr error;          // Why value was not applied; set before pending clears
+	PublicationRecord* next = nullptr; // Pointer to the next record in the list
+
+	/*!******************************************************************
+      \brief
+        Constructor for the PublicationRecord struct. Takes the first
+		value to post, so T need not be default constructible.
+
+	  \param v
+	  	The value the record starts out holding.
+    ********************************************************************/
+	explicit PublicationRecord(T const& v) : value(v)
+	{}
+};
+
+/**************************************************************************/
+/*!
+  \struct SnapshotHeader
+  \brief
+    The fixed 64-byte header of a file written by LFSV::SaveSnapshot(),
+	followed directly by the sorted values themselves. Values are stored
+	in the writing machine's byte order, which byteOrder records so a
+	reader on a different machine refuses the file rather than misreading it.
+
+*/
+/**************************************************************************/
+struct SnapshotHeader
+{
+	static const std::uint32_t currentVersion = 1;       // Bumped whenever the layout changes
+	static const std::uint32_t nativeOrder = 0x01020304; // byteOrder as written by this machine
+
+	char magic[8];            // "LFSVSNAP"
+	std::uint32_t version;    // Layout version the file was written with
+	std::uint32_t valueSize;  // sizeof(T) of the writer
+	std::uint32_t byteOrder;  // nativeOrder of the writer
+	std::uint32_t reserved;   // Zero
+	std::uint64_t count;      // # of values that follow
+	std::uint64_t checksum;   // SnapshotChecksum() of the values
+	std::uint8_t padding[24]; // Zero; keeps the values 64-byte aligned
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader: layout must stay 64 bytes");
+
+/*!******************************************************************
+  \brief
+    Checksums the values of a snapshot file: FNV-1a over 8-byte words,
+	with a shift folded in so every bit of a word reaches the result.
+
+  \param bytes
+	Pointer to the first byte to checksum.
+
+  \param length
+	The # of bytes to checksum.
+
+  \return
+	The checksum.
+********************************************************************/
+inline std::uint64_t SnapshotChecksum(void const* bytes, std::size_t length)
+{
+	unsigned char const* data = static_cast<unsigned char const*>(bytes);
+	std::uint64_t hash = 0xcbf29ce484222325ull;
+	std::size_t i = 0;
+
+	for(; i + 8 <= length; i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+	for(; i < length; ++i)
+		hash = (hash ^ data[i]) * 0x100000001b3ull;
+
+	return hash;
+}
+
+#ifdef LFSV_STATS
+/*!
+  \struct WriteCounters
+  \brief
+    One thread's write-path counters within an LFSV.
+*/
+struct WriteCounters
+{
+	std::atomic<std::uint64_t> inserts{0};     // # of values this thread published
+	std::atomic<std::uint64_t> casFailures{0}; // # of this thread's failed publish attempts
+	std::atomic<std::uint64_t> erased{0};      // # of values this thread removed
+	std::atomic<std::uint64_t> discarded{0};   // # of copies this thread threw away
+};
+#endif
+
+/**************************************************************************/
+/*!
+  \class LFSV
+  \brief  
+    A lock-free implementation of an automatically-sorting vector. Sorts
+    elements from least to greatest according to Compare, and stores each
+    version of its data in a SortedBuffer allocated through Allocator.
+	Replaced versions are handed to Reclaimer, which decides when they
+	are safe to destroy (HazardReclaimer, SharedHazardReclaimer or
+	EpochReclaimer).
+
+    Non-Core Operations Include:
+
+    -Insert a new value into the vector.
+    -Insert a batch of new values into the vector.
+    -Erase a value, a range of values, or every value matching a predicate.
+    -Erase matching values and insert a new one with a single publish.
+    -Return the value at a specific index within the vector.
+    -Pin the current version of the vector's data for reading.
+	-Hand an old/replaced vector to the reclaimer.
+	-Destroy a vector and hand its memory back to the bank.
+	-Merge a sorted run into the vector with a single publish.
+	-Rebuild the vector without some of its values with a single publish.
+	-Apply every value posted by combining writers at once.
+	-Stage a value, and merge every staged value in with a single publish.
+	-Save the values to, or load them from, a memory-mapped snapshot file.
+	-Return a snapshot of the opt-in statistics counters.
+
+*/
+/**************************************************************************/
+template <typename T = int, typename Compare = std::less<T>, typename Allocator = std::allocator<T>,
+          typename Reclaimer = HazardReclaimer>
+class LFSV 
+{
+	typedef PublicationRecord<T> Record;     // A combining writer's publication slot
+	typedef StagedValue<T> Staged;           // A value on the staging list
+
+	static const unsigned stageLimit = 1024; // # of staged values that wakes the compactor early
+	static const unsigned compactMillis = 2; // How often the compactor runs otherwise
+
+	/*!
+	  \struct Data
+	  \brief
+	    One version of the vector's data, and the seq of the newest
+	    staged value it holds. Every write carries the seq forward. A
+	    version loaded from a snapshot file borrows its values from the
+	    file's mapping, and unmaps it once the version is reclaimed.
+	*/
+	struct Data : SortedBuffer<T, Allocator>
+	{
+		std::uint64_t staged = 0;  // Staged values up to this seq are held
+		void* mapping = nullptr;   // Snapshot file mapping the values live in, if any
+		std::size_t mapped = 0;    // Size of the mapping
+
+		Data(Allocator const& allocator, BufferPool<T, Allocator>* arrays)
+			: SortedBuffer<T, Allocator>(allocator, arrays)
+		{}
+
+		~Data()
+		{
+#if defined(__unix__) || defined(__APPLE__)
+			if(mapping)
+			{
+				this->clear();
+				munmap(mapping, mapped);
+			}
+#endif
+		}
+	};
+
+	/*!
+	  \struct Staging
+	  \brief
+	    Everything WriteMode::Staged needs: the staging list, the
+	    reclaimer for values trimmed off it, and the compactor. Only a
+	    staged vector allocates one, so the other modes pay one null
+	    pointer for it.
+	*/
+	struct Staging
+	{
+		EpochReclaimer staging;                     // Decides when trimmed staged values may be deleted
+		std::atomic<Staged*> staged{nullptr};       // The newest staged value; null until a push
+		std::atomic<std::ptrdiff_t> stagedCount{0}; // # of values staged since the last flush
+		std::mutex compactorMutex;                  // Guards stopping; compactor wake-ups only
+		std::condition_variable wake;               // Wakes the compactor early, or to stop
+		bool stopping = false;                      // Whether the compactor should exit
+		std::thread compactor;                      // Merges staged values in
+	};
+
+	Compare comp;                            // Ordering of the values
+	Allocator alloc;                         // Allocator for each version's values
+	BufferPool<T, Allocator> pool;           // Recycles each version's array, capacity and all
+	MemoryBank<Data> bank;                   // Handles all Data-related memory creation/deletion
+	Reclaimer reclaimer;                     // Decides when replaced versions may be reclaimed
+    std::atomic<Data*> pdata;                // The current set of data representing the vector
+	WriteMode mode;                          // How Insert() publishes new values
+	std::atomic<Record*> records;            // Publication slots for combining writers
+	std::uint64_t recordId;                  // The records' id within ThreadSlots; 0 unless combining
+	std::atomic<bool> combining;             // Whether a thread holds the combiner role
+	ReadConsistency consistency;             // What reads see of staged values
+	std::unique_ptr<Staging> stage;          // The staging list and compactor; null unless staged
+#ifdef LFSV_STATS
+	StatBlocks<WriteCounters> writeStats;    // Per-thread write-path counters
+#endif
+	
+	/*!******************************************************************
+      \brief
+		Hand an old/replaced vector to the reclaimer, which destroys it
+		once no reader can still be using it.
+
+	  \param oldPointer
+	  	The pointer that has just been replaced.
+    ********************************************************************/
+	void Retire(Data* oldPointer)
+	{
+		reclaimer.Retire(oldPointer, [this](void* pointer)
+		{
+			Reclaim(static_cast<Data*>(pointer));
+		});
+	}
+
+	/*!******************************************************************
+      \brief
+		Destroys a version of the data and hands its memory back to the bank.
+
+	  \param pointer
+	  	The vector to reclaim.
+    ********************************************************************/
+	void Reclaim(Data* pointer)
+	{
+		pointer->~Data(); // Deletion handled later by memory bank
+		bank.store(pointer);
+	}
+
+	/*!******************************************************************
+      \brief
+		Publishes a whole new version in place of whatever is current,
+		then retires the old one. Anything staged beforehand is flushed
+		first, so it is replaced along with the rest.
+
+	  \param pdata_new
+	  	The version to publish.
+    ********************************************************************/
+	void Replace(Data* pdata_new)
+	{
+		Data* pdata_old = nullptr; // Version being replaced
+
+        if(mode == WriteMode::Staged)
+            Flush();
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+        do {
+			pdata_old = hp.Protect(pdata);
+			pdata_new->staged = pdata_old->staged;
+        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+
+		hp.Clear();
+		Retire(pdata_old);
+	}
+
+#ifdef LFSV_STATS
+	/*!******************************************************************
+      \brief
+		Records one successful publish in the calling thread's counters.
+
+	  \param values
+	  	The # of values the publish inserted.
+
+	  \param attempts
+	  	The # of CAS attempts it took, including the successful one.
+
+	  \param discarded
+	  	The # of copies thrown away along the way.
+
+	  \param erased
+	  	The # of values the publish removed.
+    ********************************************************************/
+	void CountWrite(std::uint64_t values, std::uint64_t attempts, std::uint64_t discarded,
+	                std::uint64_t erased = 0)
+	{
+		WriteCounters* counters = writeStats.Local();
+		Bump(counters->inserts, values);
+		Bump(counters->erased, erased);
+		Bump(counters->casFailures, attempts - 1);
+		Bump(counters->discarded, discarded);
+	}
+#endif
+
+	/*!******************************************************************
+      \brief
+		Merge an already sorted run into a copy of the current data in a
+		single pass, and publish the result with a single CAS. Retries
+		only re-merge against a snapshot that has actually changed.
+
+	  \param batch
+	  	The sorted run of values to merge in.
+    ********************************************************************/
+	void MergeSorted(std::vector<T> const& batch)
+	{
+        Data* pdata_new = nullptr; // Modified copy of vector data
+		Data* pdata_old = nullptr; // Pure copy of vector data
+        Data* last = nullptr;      // Used to check if merge needs to performed on new data
+		LFSV_STAT(std::uint64_t attempts = 0);
+		LFSV_STAT(std::uint64_t discarded = 0);
+		LFSV_TRACE(std::uint64_t tries = 0);
+		LFSV_TRACE(Trace(TraceEvent::MergeBegin, batch.size()));
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+        do {
+			LFSV_STAT(++attempts);
+
+			// Store old pointer to ensure safe reading
+			pdata_old = hp.Protect(pdata);
+
+            if(last != pdata_old)
+            {
+                // Reuse the copy from the previous attempt as scratch space
+                if(pdata_new)
+                {
+					pdata_new->clear();
+					LFSV_STAT(++discarded);
+                }
+                else
+					pdata_new = new (bank.get()) Data(alloc, &pool);
+
+				try
+				{
+					pdata_new->reserve(pdata_old->size() + batch.size());
+					std::merge(pdata_old->begin(), pdata_old->end(), batch.begin(), batch.end(),
+					           std::back_inserter(*pdata_new), comp);
+				}
+				catch(...)
+				{
+					Reclaim(pdata_new);
+					throw;
+				}
+				pdata_new->staged = pdata_old->staged;
+
+                last = pdata_old;
+            }
+			LFSV_TRACE(Trace(TraceEvent::CasAttempt, ++tries));
+        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+		LFSV_TRACE(Trace(TraceEvent::MergeCommit, tries));
+
+		hp.Clear();
+		Retire(pdata_old);
+		LFSV_STAT(CountWrite(batch.size(), attempts, discarded));
+	}
+
+	/*!******************************************************************
+      \brief
+		Rebuild the data without some of its values (and optionally with
+		one new value), and publish the result with a single CAS. Uses
+		the same copy, publish and retire protocol as Insert(); retries
+		only rebuild against a snapshot that has actually changed. If a
+		rebuild removes nothing and adds nothing, nothing is published.
+
+	  \param build
+	  	Called as build(old, fresh) to fill the empty fresh copy from
+		old. Returns the # of values it removed.
+
+	  \param added
+	  	The # of values build() adds (0 or 1).
+
+	  \return
+	  	The # of values removed by the published rebuild.
+    ********************************************************************/
+	template <typename Builder>
+	std::size_t Rewrite(Builder build, std::size_t added)
+	{
+        Data* pdata_new = nullptr; // Rebuilt copy of vector data
+		Data* pdata_old = nullptr; // Pure copy of vector data
+        Data* last = nullptr;      // Used to check if the rebuild needs to performed on new data
+		std::size_t removed = 0;   // # of values removed by the latest rebuild
+		LFSV_STAT(std::uint64_t attempts = 0);
+		LFSV_STAT(std::uint64_t discarded = 0);
+
+		// Staged values must be in the data before they can be removed
+		if(mode == WriteMode::Staged)
+			Flush();
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+        do {
+			LFSV_STAT(++attempts);
+
+			// Store old pointer to ensure safe reading
+			pdata_old = hp.Protect(pdata);
+
+            if(last != pdata_old)
+            {
+                // Reuse the copy from the previous attempt as scratch space
+                if(pdata_new)
+                {
+					pdata_new->clear();
+					LFSV_STAT(++discarded);
+                }
+                else
+					pdata_new = new (bank.get()) Data(alloc, &pool);
+
+				pdata_new->reserve(pdata_old->size() + added);
+				removed = build(*pdata_old, *pdata_new);
+				pdata_new->staged = pdata_old->staged;
+
+				// Nothing to change, so there is nothing to publish
+				if(removed == 0 && added == 0)
+				{
+					Reclaim(pdata_new);
+					return 0;
+				}
+
+                last = pdata_old;
+            }
+        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+
+		hp.Clear();
+		Retire(pdata_old);
+		LFSV_STAT(CountWrite(added, attempts, discarded, removed));
+		return removed;
+	}
+
+	/*!******************************************************************
+      \brief
+		Hands a publication record back when the owning thread exits.
+
+	  \param owner
+	  	Unused.
+
+	  \param record
+	  	The record.
+    ********************************************************************/
+	static void OnThreadExit(void*, void* record)
+	{
+		static_cast<Record*>(record)->active.store(false);
+	}
+
+	/*!******************************************************************
+      \brief
+		Provides the calling thread's publication record to post a value
+		in. The first call on each thread claims a released record (or
+		links a new one) and keeps it for the thread's lifetime.
+
+	  \param v
+	  	The value about to be posted, which a new record starts out with.
+
+	  \param borrowed
+	  	Set if the thread is already shutting down, in which case the
+		record is only lent and must be released after use.
+
+	  \return
+	  	The publication record to use.
+    ********************************************************************/
+	Record* GetRecord(T const& v, bool& borrowed)
+	{
+		void* found = ThreadSlots::Find(recordId);
+		borrowed = false;
+		if(found)
+			return static_cast<Record*>(found);
+		borrowed = ThreadSlots::Exiting();
+
+		Record* record = records.load();
+		for(; record != nullptr; record = record->next)
+		{
+			bool f = false;
+			if(!record->active.load() && record->active.compare_exchange_strong(f, true))
+				break;
+		}
+
+		if(record == nullptr)
+		{
+			record = new Record(v);
+			record->active.store(true);
+
+			Record* oldRecord = nullptr;
+			do
+			{
+				oldRecord = records.load();
+				record->next = oldRecord;
+			} while (!records.compare_exchange_weak(oldRecord, record));
+		}
+
+		if(!borrowed)
+			ThreadSlots::Add(recordId, record, &LFSV::OnThreadExit, this);
+		return record;
+	}
+
+	/*!******************************************************************
+      \brief
+		Acts as the combiner: collects every pending value that has been
+		posted, applies them all in one merge and one publish, and then
+		marks each of their records as done. If collecting or applying
+		them throws, every record already collected is marked done with
+		the exception, so its poster stops waiting and rethrows it, and
+		the exception is passed on to the combiner's own caller.
+    ********************************************************************/
+	void Combine()
+	{
+		std::vector<Record*> served;
+
+		try
+		{
+			std::vector<T> batch;
+			for(Record* curr = records.load(); curr != nullptr; curr = curr->next)
+			{
+				if(curr->pending.load(std::memory_order_acquire))
+				{
+					served.push_back(curr);
+					batch.push_back(curr->value);
+				}
+			}
+
+			if(!batch.empty())
+			{
+				std::sort(batch.begin(), batch.end(), comp);
+				MergeSorted(batch);
+			}
+		}
+		catch(...)
+		{
+			for(Record* record : served)
+			{
+				record->error = std::current_exception();
+				record->pending.store(false, std::memory_order_release);
+			}
+			throw;
+		}
+
+		for(Record* record : served)
+			record->pending.store(false, std::memory_order_release);
+	}
+
+	/*!******************************************************************
+      \brief
+		Insert a new value by posting it for the current combiner, or
+		by becoming the combiner if no other thread holds the role. If
+		the combiner fails to apply the value, its exception is rethrown
+		here and the value is not inserted.
+
+	  \param v
+	  	Reference to the new value to insert into the vector.
+    ********************************************************************/
+	void InsertCombining(T const& v)
+	{
+		bool borrowed = false;
+		Record* record = GetRecord(v, borrowed);
+		std::exception_ptr error;
+
+		try
+		{
+			record->value = v;
+			record->pending.store(true, std::memory_order_release);
+
+			while(record->pending.load(std::memory_order_acquire))
+			{
+				bool f = false;
+				if(!combining.load() && combining.compare_exchange_strong(f, true))
+				{
+					try
+					{
+						Combine();
+					}
+					catch(...)
+					{
+						// Withdraw the value if the failed pass never collected it
+						record->pending.store(false, std::memory_order_relaxed);
+						record->error = nullptr;
+						combining.store(false, std::memory_order_release);
+						throw;
+					}
+					combining.store(false, std::memory_order_release);
+				}
+				else
+					std::this_thread::yield();
+			}
+		}
+		catch(...)
+		{
+			error = std::current_exception();
+		}
+
+		if(!error)
+			std::swap(error, record->error);
+		if(borrowed)
+			record->active.store(false);
+		if(error)
+			std::rethrow_exception(error);
+	}
+
+	/*!******************************************************************
+      \brief
+		Insert a new value by pushing it onto the staging list, leaving
+		the compactor to merge it in. Wakes the compactor early once
+		enough values have piled up.
+
+	  \param v
+	  	Reference to the new value to insert into the vector.
+    ********************************************************************/
+	void InsertStaged(T const& v)
+	{
+		Staged* node = new Staged(v);
+
+		// The guard keeps the value below from being trimmed and deleted
+		EpochReclaimer::Guard sg(stage->staging);
+		Staged* below = sg.Protect(stage->staged);
+		do {
+			node->seq = (below ? below->seq : 0) + 1;
+			node->next.store(below, std::memory_order_relaxed);
+		} while (!stage->staged.compare_exchange_weak(below, node));
+		sg.Clear();
+
+		if(stage->stagedCount.fetch_add(1, std::memory_order_relaxed) + 1 == stageLimit)
+			stage->wake.notify_one();
+	}
+
+	/*!******************************************************************
+      \brief
+		Cuts every value a published version already holds off the
+		staging list, and retires the cut run. The newest value always
+		stays, so the next push can number itself from it.
+
+	  \param sg
+	  	The calling thread's staging guard.
+
+	  \param held
+	  	The seq of the newest staged value the published data holds.
+    ********************************************************************/
+	void Trim(EpochReclaimer::Guard& sg, std::uint64_t held)
+	{
+		Staged* keep = sg.Protect(stage->staged);
+		for(Staged* below = keep->next.load(); below != nullptr && below->seq > held;
+		    below = below->next.load())
+			keep = below;
+
+		Staged* run = keep->next.exchange(nullptr);
+		if(run)
+			stage->staging.Retire(run, &Staged::DeleteRun);
+	}
+
+	/*!******************************************************************
+      \brief
+		Return the value at a specific index within the data plus every
+		value still staged, without publishing anything. Retries if a
+		flush publishes while the staging list is being read, so the
+		data and the staged values always match.
+
+      \param pos
+        The index to pull a value from.
+
+      \return
+        The value at the specified position.
+    ********************************************************************/
+	T ReadStaged(std::size_t pos)
+	{
+		Data* pdata_old = nullptr;  // Pure copy of vector data
+		std::vector<T> pending;     // Staged values the data does not hold yet
+
+		typename Reclaimer::Guard hp(reclaimer);
+		EpochReclaimer::Guard sg(stage->staging);
+
+		do {
+			pdata_old = hp.Protect(pdata);
+			pending.clear();
+			for(Staged* node = sg.Protect(stage->staged); node != nullptr && node->seq > pdata_old->staged;
+			    node = node->next.load())
+				pending.push_back(node->value);
+		} while (pdata.load() != pdata_old);
+
+		// Staged values land after equal values already in the data, as Insert() would place them
+		std::sort(pending.begin(), pending.end(), comp);
+		std::size_t before = 0; // # of staged values ahead of pos
+		for(; before < pending.size(); ++before)
+		{
+			std::size_t at = static_cast<std::size_t>(
+				FindUpperBound(pdata_old->begin(), pdata_old->end(), pending[before], comp)
+				- pdata_old->begin()) + before;
+			if(at == pos)
+				return pending[before];
+			if(at > pos)
+				break;
+		}
+
+		T ret_val = (*pdata_old)[pos - before];
+
+		sg.Clear();
+		hp.Clear();
+
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+		Checks a snapshot file's header against this vector's value type.
+
+	  \param header
+	  	The header read from the file.
+
+	  \param bytes
+	  	The size of the whole file.
+    ********************************************************************/
+	static void CheckHeader(SnapshotHeader const& header, std::uint64_t bytes)
+	{
+		if(std::memcmp(header.magic, "LFSVSNAP", 8) != 0)
+			throw std::runtime_error("LFSV: not a snapshot file");
+		if(header.version != SnapshotHeader::currentVersion)
+			throw std::runtime_error("LFSV: unsupported snapshot version");
+		if(header.valueSize != sizeof(T) || header.byteOrder != SnapshotHeader::nativeOrder)
+			throw std::runtime_error("LFSV: snapshot was written for a different value type or machine");
+		if(header.reserved != 0 || std::count(header.padding, header.padding + sizeof(header.padding), 0) !=
+		   static_cast<std::ptrdiff_t>(sizeof(header.padding)))
+			throw std::runtime_error("LFSV: snapshot header is corrupt");
+		if(header.count > (bytes - sizeof(SnapshotHeader)) / sizeof(T) ||
+		   sizeof(SnapshotHeader) + header.count * sizeof(T) != bytes)
+			throw std::runtime_error("LFSV: snapshot file is truncated");
+	}
+
+	/*!******************************************************************
+      \brief
+		Writes a snapshot file: the header, then the values. Where POSIX
+		is available the file is written under a unique temporary name,
+		synced to disk, renamed over path, and then the directory is
+		synced, so after a crash or power loss path holds either the old
+		snapshot or the whole new one. The file is created with the
+		process's umask applied, as std::fopen() would create it.
+		Elsewhere the file is written next to path and renamed over it,
+		without the syncs.
+
+	  \param path
+	  	The file to write.
+
+	  \param header
+	  	The header to write.
+
+	  \param values
+	  	The values to write after it.
+    ********************************************************************/
+	static void WriteSnapshot(char const* path, SnapshotHeader const& header, T const* values)
+	{
+		std::string temp;
+#if defined(__unix__) || defined(__APPLE__)
+		// Named by process and by call, so concurrent saves never share a file
+		static std::atomic<std::uint64_t> serial(0);
+		int fd = -1;
+		do
+		{
+			temp = std::string(path) + "." + std::to_string(getpid()) + "." + std::to_string(serial.fetch_add(1));
+			fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+		} while(fd < 0 && errno == EEXIST);
+		if(fd < 0)
+			throw std::runtime_error("LFSV: cannot create snapshot file");
+		std::FILE* file = fdopen(fd, "wb");
+		if(!file)
+			close(fd);
+#else
+		temp = std::string(path) + ".tmp";
+		std::FILE* file = std::fopen(temp.c_str(), "wb");
+#endif
+		if(!file)
+		{
+			std::remove(temp.c_str());
+			throw std::runtime_error("LFSV: cannot create snapshot file");
+		}
+
+		bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+		               (header.count == 0 || std::fwrite(values, sizeof(T), header.count, file) == header.count) &&
+		               std::fflush(file) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+		written = written && fsync(fileno(file)) == 0;
+#endif
+		written = std::fclose(file) == 0 && written;
+		if(!written || std::rename(temp.c_str(), path) != 0)
+		{
+			std::remove(temp.c_str());
+			throw std::runtime_error("LFSV: cannot write snapshot file");
+		}
+
+#if defined(__unix__) || defined(__APPLE__)
+		// The rename itself only lasts once the directory holding it is synced
+		std::string directory(path);
+		std::size_t slash = directory.find_last_of('/');
+		directory = slash == std::string::npos ? "." : slash == 0 ? "/" : directory.substr(0, slash);
+		int dir = open(directory.c_str(), O_RDONLY);
+		bool synced = dir >= 0 && fsync(dir) == 0;
+		if(dir >= 0)
+			close(dir);
+		if(!synced)
+			throw std::runtime_error("LFSV: cannot sync snapshot directory");
+#endif
+	}
+
+	/*!******************************************************************
+      \brief
+		Fills a fresh version with the values of a snapshot file. Where
+		mmap is available the version borrows them straight from a
+		read-only mapping, so nothing is copied until the first write;
+		elsewhere they are read into an array of its own.
+
+	  \param path
+	  	The snapshot file to read.
+
+	  \param fresh
+	  	The empty version to fill.
+    ********************************************************************/
+	static void ReadSnapshot(char const* path, Data& fresh)
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		int fd = open(path, O_RDONLY);
+		if(fd < 0)
+			throw std::runtime_error("LFSV: cannot open snapshot file");
+
+		struct stat info;
+		if(fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader)))
+		{
+			close(fd);
+			throw std::runtime_error("LFSV: snapshot file is truncated");
+		}
+
+		std::size_t length = static_cast<std::size_t>(info.st_size);
+		void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(mapping == MAP_FAILED)
+			throw std::runtime_error("LFSV: cannot map snapshot file");
+
+		// From here on the version owns the mapping, even if a check below throws
+		fresh.mapping = mapping;
+		fresh.mapped = length;
+
+		SnapshotHeader const* header = static_cast<SnapshotHeader const*>(mapping);
+		T const* values = reinterpret_cast<T const*>(header + 1);
+		CheckHeader(*header, length);
+		if(SnapshotChecksum(values, header->count * sizeof(T)) != header->checksum)
+			throw std::runtime_error("LFSV: snapshot checksum mismatch");
+
+		fresh.borrow(values, header->count);
+#else
+		std::FILE* file = std::fopen(path, "rb");
+		if(!file)
+			throw std::runtime_error("LFSV: cannot open snapshot file");
+
+		SnapshotHeader header;
+		std::vector<T> values;
+		bool read = std::fread(&header, sizeof(header), 1, file) == 1 &&
+		            std::fseek(file, 0, SEEK_END) == 0;
+		long length = read ? std::ftell(file) : -1;
+		try
+		{
+			if(length < static_cast<long>(sizeof(SnapshotHeader)))
+				throw std::runtime_error("LFSV: snapshot file is truncated");
+			CheckHeader(header, static_cast<std::uint64_t>(length));
+			values.resize(header.count);
+			std::fseek(file, sizeof(SnapshotHeader), SEEK_SET);
+			if(std::fread(values.data(), sizeof(T), values.size(), file) != values.size())
+				throw std::runtime_error("LFSV: snapshot file is truncated");
+		}
+		catch(...)
+		{
+			std::fclose(file);
+			throw;
+		}
+		std::fclose(file);
+
+		if(SnapshotChecksum(values.data(), values.size() * sizeof(T)) != header.checksum)
+			throw std::runtime_error("LFSV: snapshot checksum mismatch");
+		fresh.append(values.data(), values.data() + values.size());
+#endif
+	}
+
+	/*!******************************************************************
+      \brief
+		The compactor thread's loop: flushes every compactMillis, or
+		sooner once stageLimit values are waiting, until told to stop.
+    ********************************************************************/
+	void Compact()
+	{
+		std::unique_lock<std::mutex> lock(stage->compactorMutex);
+		while(!stage->stopping)
+		{
+			stage->wake.wait_for(lock, std::chrono::milliseconds(static_cast<long>(compactMillis)), [this]()
+			{
+				return stage->stopping ||
+				       stage->stagedCount.load(std::memory_order_relaxed) >= std::ptrdiff_t(stageLimit);
+			});
+
+			lock.unlock();
+			Flush();
+			lock.lock();
+		}
+	}
+
+    public:
+
+    /**************************************************************************/
+    /*!
+      \class Snapshot
+      \brief  
+        A read-only view of one version of the vector's data, pinned by the
+        reclaimer for as long as the handle lives. Reads
+        through a snapshot cost the same as reads of a plain std::vector
+        and always see a consistent set of values. A snapshot must be
+        destroyed on the thread that created it.
+
+        Non-Core Operations Include:
+
+        -Return the number of values within the snapshot.
+        -Iterate over the values within the snapshot.
+        -Find the range of values equal to, or bounding, a given value.
+        -Rank, select, count, sum or take a percentile of the values.
+        -Copy a range of values out of the snapshot.
+
+    */
+    /**************************************************************************/
+    class Snapshot
+    {
+        typename Reclaimer::Pin pin;   // Keeps the pinned version from being reclaimed
+        Data const* data;              // The pinned version of the vector's data
+        Compare comp;                  // Ordering of the values
+
+        public:
+
+        typedef T const* const_iterator;
+
+        /*!******************************************************************
+          \brief
+            Constructor for the Snapshot class. Pins the current version
+            of a container's data.
+
+          \param reclaimer
+            The reclaimer of the container.
+
+          \param source
+            The container's current data pointer.
+
+          \param compare
+            The ordering of the container's values.
+        ********************************************************************/
+        Snapshot(Reclaimer& reclaimer, std::atomic<Data*> const& source, Compare const& compare)
+            : pin(reclaimer), data(pin.Protect(source)), comp(compare)
+        {}
+
+        /*!******************************************************************
+          \brief
+            Move constructor for the Snapshot class.
+
+          \param other
+            The snapshot to take the pin from.
+        ********************************************************************/
+        Snapshot(Snapshot&& other) : pin(std::move(other.pin)), data(other.data), comp(other.comp)
+        {}
+
+        Snapshot(Snapshot const&) = delete;
+        Snapshot& operator=(Snapshot const&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        /*!******************************************************************
+          \brief
+            Return the number of values within the snapshot.
+
+          \return
+            The number of values.
+        ********************************************************************/
+        std::size_t size() const
+        {
+            return data->size();
+        }
+
+        /*!******************************************************************
+          \brief
+            Return whether the snapshot holds no values.
+
+          \return
+            Whether the snapshot is empty.
+        ********************************************************************/
+        bool empty() const
+        {
+            return data->empty();
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the value at a specific index within the snapshot.
+
+          \param pos
+            The index within the snapshot to pull a value from.
+
+          \return
+            The value at the specified position.
+        ********************************************************************/
+        T const& operator[](std::size_t pos) const
+        {
+            return (*data)[pos];
+        }
+
+        /*!******************************************************************
+          \brief
+            Return an iterator to the first value within the snapshot.
+
+          \return
+            The iterator.
+        ********************************************************************/
+        const_iterator begin() const
+        {
+            return data->begin();
+        }
+
+        /*!******************************************************************
+          \brief
+            Return an iterator past the last value within the snapshot.
+
+          \return
+            The iterator.
+        ********************************************************************/
+        const_iterator end() const
+        {
+            return data->end();
+        }
+
+        /*!******************************************************************
+          \brief
+            Return an iterator to the first value not less than v.
+
+          \param v
+            The value to search for.
+
+          \return
+            The iterator.
+        ********************************************************************/
+        const_iterator lower_bound(T const& v) const
+        {
+            return std::lower_bound(data->begin(), data->end(), v, comp);
+        }
+
+        /*!******************************************************************
+          \brief
+            Return an iterator to the first value greater than v.
+
+          \param v
+            The value to search for.
+
+          \return
+            The iterator.
+        ********************************************************************/
+        const_iterator upper_bound(T const& v) const
+        {
+            return std::upper_bound(data->begin(), data->end(), v, comp);
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the range of values equal to v.
+
+          \param v
+            The value to search for.
+
+          \return
+            The lower and upper bounds of the range.
+        ********************************************************************/
+        std::pair<const_iterator, const_iterator> equal_range(T const& v) const
+        {
+            return std::equal_range(data->begin(), data->end(), v, comp);
+        }
+
+        /*!******************************************************************
+          \brief
+            Return whether the snapshot holds at least one copy of v.
+
+          \param v
+            The value to search for.
+
+          \return
+            Whether v is present.
+        ********************************************************************/
+        bool contains(T const& v) const
+        {
+            return std::binary_search(data->begin(), data->end(), v, comp);
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the # of values less than v, which is also the index
+            v would be inserted at ahead of any equal values.
+
+          \param v
+            The value to rank.
+
+          \return
+            The rank of v.
+        ********************************************************************/
+        std::size_t Rank(T const& v) const
+        {
+            return static_cast<std::size_t>(lower_bound(v) - data->begin());
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the k-th smallest value (counting from 0).
+
+          \param k
+            The rank of the value to return.
+
+          \return
+            The value.
+        ********************************************************************/
+        T const& Select(std::size_t k) const
+        {
+            if(k >= data->size())
+                throw std::out_of_range("LFSV: select rank out of range");
+            return (*data)[k];
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the # of values within [lo, hi).
+
+          \param lo
+            The lowest value to count.
+
+          \param hi
+            The value to stop counting at.
+
+          \return
+            The # of values within the range.
+        ********************************************************************/
+        std::size_t CountRange(T const& lo, T const& hi) const
+        {
+            std::size_t low = Rank(lo);
+            std::size_t high = Rank(hi);
+            return high > low ? high - low : 0;
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the value at the p-th percentile, by nearest rank.
+
+          \param p
+            The percentile, from 0 to 100.
+
+          \return
+            The value.
+        ********************************************************************/
+        T const& Percentile(double p) const
+        {
+            if(data->empty())
+                throw std::out_of_range("LFSV: percentile of an empty snapshot");
+            return (*data)[PercentileIndex(p, data->size())];
+        }
+
+        /*!******************************************************************
+          \brief
+            Return the sum of the values within [lo, hi). A flat version
+            keeps no running sums, so this walks the range.
+
+          \param lo
+            The lowest value to add.
+
+          \param hi
+            The value to stop adding at.
+
+          \return
+            The sum, in ValueSum<T>::type.
+        ********************************************************************/
+        typename ValueSum<T>::type SumRange(T const& lo, T const& hi) const
+        {
+            static_assert(std::is_arithmetic<T>::value, "LFSV: SumRange needs arithmetic values");
+
+            typename ValueSum<T>::type sum = 0;
+            for(const_iterator it = lower_bound(lo), last = lower_bound(hi); it < last; ++it)
+                sum += *it;
+            return sum;
+        }
+
+        /*!******************************************************************
+          \brief
+            Copy a range of values out of the snapshot. The range is
+            clamped to the size of the snapshot.
+
+          \param pos
+            The index of the first value to copy.
+
+          \param count
+            The number of values to copy.
+
+          \param out
+            The output iterator to copy to.
+
+          \return
+            The output iterator past the last value copied.
+        ********************************************************************/
+        template <typename OutputIt>
+        OutputIt copy(std::size_t pos, std::size_t count, OutputIt out) const
+        {
+            if(pos >= data->size())
+                return out;
+            count = std::min(count, data->size() - pos);
+            return std::copy(data->begin() + pos, data->begin() + pos + count, out);
+        }
+    };
+
+    /*!******************************************************************
+      \brief
+        Pin the current version of the vector's data for reading. Under
+        WriteMode::Staged, flushes staged values first.
+
+      \return
+        A snapshot handle holding the pin.
+    ********************************************************************/
+    Snapshot GetSnapshot()
+    {
+        // A snapshot hands out the data itself, so staged values must be in it
+        if(mode == WriteMode::Staged)
+            Flush();
+
+        return Snapshot(reclaimer, pdata, comp);
+    }
+
+    /*!******************************************************************
+      \brief
+        Constructor for the LFSV class.
+
+      \param writeMode
+        How Insert() should publish new values.
+
+      \param compare
+        The ordering to sort values by.
+
+      \param allocator
+        The allocator to use for each version's values.
+
+      \param reads
+        What reads see of values still staged under WriteMode::Staged.
+    ********************************************************************/
+    LFSV(WriteMode writeMode = WriteMode::CAS, Compare const& compare = Compare(),
+         Allocator const& allocator = Allocator(), ReadConsistency reads = ReadConsistency::Merge)
+        : comp(compare), alloc(allocator), pool(allocator), bank(), reclaimer(),
+          pdata(new (bank.get()) Data(alloc, &pool)),
+          mode(writeMode), records(nullptr),
+          recordId(writeMode == WriteMode::Combining ? ThreadSlots::Register() : 0), combining(false), consistency(reads),
+          stage(writeMode == WriteMode::Staged ? new Staging() : nullptr)
+    {
+        if(stage)
+            stage->compactor = std::thread(&LFSV::Compact, this);
+    }
+
+    /*!******************************************************************
+      \brief
+        Constructor for the LFSV class, bulk loading an initial set of
+        values. See Rebuild().
+
+      \param values
+        Pointer to the first initial value; need not be sorted.
+
+      \param count
+        The number of initial values.
+
+      \param threads
+        The # of threads to sort with, counting the caller; 0 means one
+        per hardware thread.
+
+      \param writeMode
+        How Insert() should publish new values.
+
+      \param compare
+        The ordering to sort values by.
+
+      \param allocator
+        The allocator to use for each version's values.
+
+      \param reads
+        What reads see of values still staged under WriteMode::Staged.
+    ********************************************************************/
+    LFSV(T const* values, std::size_t count, unsigned threads = 0,
+         WriteMode writeMode = WriteMode::CAS, Compare const& compare = Compare(),
+         Allocator const& allocator = Allocator(), ReadConsistency reads = ReadConsistency::Merge)
+        : LFSV(writeMode, compare, allocator, reads)
+    {
+        Rebuild(values, count, threads);
+    }
+
+    /*!******************************************************************
+      \brief
+        Destructor for the LFSV class.
+    ********************************************************************/
+    ~LFSV() 
+    { 
+        if(stage)
+        {
+            {
+                std::lock_guard<std::mutex> lock(stage->compactorMutex);
+                stage->stopping = true;
+            }
+            stage->wake.notify_one();
+            stage->compactor.join();
+        }
+
+        Reclaim(pdata.load());
+
+		// Allocated publication records must be taken care of, once no
+		// exiting thread can hand one back
+		if(recordId != 0)
+			ThreadSlots::Unregister(recordId);
+		Record* record = records.load();
+		while(record != nullptr)
+		{
+			Record* temp = record;
+			record = record->next;
+			delete temp;
+		}
+
+		// Every remaining retired pointer should be sent to memory bank;
+		// no other thread may be using the container at this point
+		reclaimer.Drain();
+
+		if(stage)
+		{
+			Staged::DeleteRun(stage->staged.load());
+			stage->staging.Drain();
+		}
+    }
+
+    /*!******************************************************************
+      \brief
+        Insert a new value into the vector.
+
+      \param v
+        Reference to the new value to insert into the vector.
+    ********************************************************************/
+    void Insert(T const& v) 
+    {      
+		LFSV_TRACE(Trace(TraceEvent::InsertBegin));
+
+        if(mode == WriteMode::Combining)
+        {
+            InsertCombining(v);
+            LFSV_TRACE(Trace(TraceEvent::CasCommit));
+            return;
+        }
+        if(mode == WriteMode::Staged)
+        {
+            InsertStaged(v);
+            LFSV_TRACE(Trace(TraceEvent::CasCommit));
+            return;
+        }
+
+        Data* pdata_new = nullptr; // Modified copy of vector data
+		Data* pdata_old = nullptr; // Pure copy of vector data
+        Data* last = nullptr;      // Used to check if insert needs to performed on new data
+		LFSV_STAT(std::uint64_t attempts = 0);
+		LFSV_STAT(std::uint64_t discarded = 0);
+		LFSV_TRACE(std::uint64_t tries = 0);
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+        do {
+			LFSV_STAT(++attempts);
+
+			// Store old pointer to ensure safe reading
+			pdata_old = hp.Protect(pdata);
+
+            // If the insertion needs to be performed again,
+            if(last != pdata_old)
+            {
+                // Reuse the "new" copy from the previous loop as scratch space,
+                // or pull new memory and make a new reference
+                if(pdata_new)
+                {
+					LFSV_STAT(++discarded);
+                }
+                else
+					pdata_new = new (bank.get()) Data(alloc, &pool);
+                
+                // Find where the new element goes, then copy around it in one pass
+				typename Data::const_iterator b = pdata_old->begin();
+				typename Data::const_iterator e = pdata_old->end();
+				std::size_t pos = (b == e || !comp(v, pdata_old->back()))
+					? pdata_old->size() // first in empty or last element
+					: static_cast<std::size_t>(FindUpperBound(b, e, v, comp) - b);
+				pdata_new->assign(*pdata_old, pos, v);
+				pdata_new->staged = pdata_old->staged;
+
+                last = pdata_old; // Update record of most recent data set
+            }
+			LFSV_TRACE(Trace(TraceEvent::CasAttempt, ++tries));
+        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+		LFSV_TRACE(Trace(TraceEvent::CasCommit, tries));
+
+        // Release the guard and retire the "old" pointer/data after it has been replaced
+		hp.Clear();
+		Retire(pdata_old);
+		LFSV_STAT(CountWrite(1, attempts, discarded));
+    }
+
+    /*!******************************************************************
+      \brief
+        Insert a batch of new values into the vector. The batch is
+		sorted once, merged into a copy of the current data in a single
+		pass, and published with a single CAS.
+
+      \param values
+        Pointer to the first value of the batch.
+
+      \param count
+        The number of values within the batch.
+    ********************************************************************/
+    void InsertBatch(T const* values, std::size_t count)
+    {
+        if(count == 0)
+            return;
+
+        std::vector<T> batch(values, values + count); // Locally sorted run
+        std::sort(batch.begin(), batch.end(), comp);
+
+        MergeSorted(batch);
+    }
+
+    /*!******************************************************************
+      \brief
+        Replace every value in the vector with a new set, with a single
+        publish. The values need not be sorted; they are sorted across a
+        pool of threads first, then copied into the new version in one
+        pass. The old version is retired like any other, so readers
+        already holding it are unaffected.
+
+      \param values
+        Pointer to the first of the new values.
+
+      \param count
+        The number of new values.
+
+      \param threads
+        The # of threads to sort with, counting the caller; 0 means one
+        per hardware thread.
+    ********************************************************************/
+    void Rebuild(T const* values, std::size_t count, unsigned threads = 0)
+    {
+        std::vector<T> sorted(values, values + count); // The new values, in order
+        ParallelSort(sorted, comp, threads);
+
+        Data* pdata_new = new (bank.get()) Data(alloc, &pool); // Version holding only the new values
+
+        try
+        {
+            pdata_new->reserve(sorted.size());
+            pdata_new->append(sorted.data(), sorted.data() + sorted.size());
+        }
+        catch(...)
+        {
+            Reclaim(pdata_new);
+            throw;
+        }
+
+        Replace(pdata_new);
+    }
+
+    /*!******************************************************************
+      \brief
+        Erase one copy of a value from the vector.
+
+      \param v
+        The value to erase.
+
+      \return
+        Whether a copy of the value was found and erased.
+    ********************************************************************/
+    bool Erase(T const& v)
+    {
+        return Rewrite([this, &v](Data const& old, Data& fresh) -> std::size_t
+        {
+            T const* found = std::lower_bound(old.begin(), old.end(), v, comp);
+            if(found == old.end() || comp(v, *found))
+                return 0;
+
+            fresh.append(old.begin(), found);
+            fresh.append(found + 1, old.end());
+            return 1;
+        }, 0) != 0;
+    }
+
+    /*!******************************************************************
+      \brief
+        Erase every value within [lo, hi) from the vector.
+
+      \param lo
+        The lowest value to erase.
+
+      \param hi
+        The value to stop erasing at; it is not erased itself.
+
+      \return
+        The # of values erased.
+    ********************************************************************/
+    std::size_t EraseRange(T const& lo, T const& hi)
+    {
+        return Rewrite([this, &lo, &hi](Data const& old, Data& fresh) -> std::size_t
+        {
+            T const* first = std::lower_bound(old.begin(), old.end(), lo, comp);
+            T const* last = std::lower_bound(first, old.end(), hi, comp);
+
+            fresh.append(old.begin(), first);
+            fresh.append(last, old.end());
+            return static_cast<std::size_t>(last - first);
+        }, 0);
+    }
+
+    /*!******************************************************************
+      \brief
+        Erase every value matching a predicate from the vector, with a
+        single publish. The predicate may be called more than once per
+        value if another thread publishes in the meantime.
+
+      \param pred
+        Called with each value; returns whether to erase it.
+
+      \return
+        The # of values erased.
+    ********************************************************************/
+    template <typename Predicate>
+    std::size_t EraseIf(Predicate pred)
+    {
+        return Rewrite([&pred](Data const& old, Data& fresh) -> std::size_t
+        {
+            for(T const& value : old)
+                if(!pred(value))
+                    fresh.push_back(value);
+            return old.size() - fresh.size();
+        }, 0);
+    }
+
+    /*!******************************************************************
+      \brief
+        Erase every value matching a predicate and insert a new value,
+        with a single publish, so a sliding window never holds both the
+        expired values and the new one at once. The predicate may be
+        called more than once per value if another thread publishes in
+        the meantime.
+
+      \param pred
+        Called with each value; returns whether to erase it.
+
+      \param v
+        Reference to the new value to insert into the vector.
+
+      \return
+        The # of values erased.
+    ********************************************************************/
+    template <typename Predicate>
+    std::size_t EraseIfAndInsert(Predicate pred, T const& v)
+    {
+        return Rewrite([this, &pred, &v](Data const& old, Data& fresh) -> std::size_t
+        {
+            bool placed = false;
+            for(T const& value : old)
+            {
+                if(pred(value))
+                    continue;
+                if(!placed && comp(v, value))
+                {
+                    fresh.push_back(v);
+                    placed = true;
+                }
+                fresh.push_back(value);
+            }
+            if(!placed)
+                fresh.push_back(v);
+            return old.size() + 1 - fresh.size();
+        }, 1);
+    }
+
+    /*!******************************************************************
+      \brief
+        Write the current values to a file, as a SnapshotHeader followed
+        by the values themselves. The file is written and synced under a
+        unique name next to path, then renamed over it, so neither a crash
+        nor a concurrent save to the same path leaves a torn snapshot
+        behind. Throws std::runtime_error if the file cannot be written.
+
+      \param path
+        The file to write.
+    ********************************************************************/
+    void SaveSnapshot(char const* path)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "LFSV: only trivial values can be saved");
+
+        Snapshot snapshot = GetSnapshot();
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, "LFSVSNAP", 8);
+        header.version = SnapshotHeader::currentVersion;
+        header.valueSize = sizeof(T);
+        header.byteOrder = SnapshotHeader::nativeOrder;
+        header.count = snapshot.size();
+        header.checksum = SnapshotChecksum(snapshot.begin(), snapshot.size() * sizeof(T));
+
+        WriteSnapshot(path, header, snapshot.begin());
+    }
+
+    /*!******************************************************************
+      \brief
+        Replace the vector's values with those of a file written by
+        SaveSnapshot(), with a single publish. The file is mapped rather
+        than read, so loading costs one pass to verify the checksum, and
+        the mapped pages are only copied by the first write after it.
+        The file must have been saved with the same ordering. Throws
+        std::runtime_error, leaving the vector untouched, if the file is
+        missing, corrupt, or written for a different value type.
+
+      \param path
+        The file to load.
+    ********************************************************************/
+    void LoadSnapshot(char const* path)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "LFSV: only trivial values can be loaded");
+
+        Data* pdata_new = new (bank.get()) Data(alloc, &pool); // Version borrowing the file's values
+
+        try
+        {
+            ReadSnapshot(path, *pdata_new);
+        }
+        catch(...)
+        {
+            Reclaim(pdata_new);
+            throw;
+        }
+
+        Replace(pdata_new);
+    }
+
+    /*!******************************************************************
+      \brief
+        Merge every value staged so far into the data with a single
+        publish, then trim them off the staging list. Called by the
+        compactor, and by any read or erase that needs the data current.
+        Does nothing unless the vector is in WriteMode::Staged.
+    ********************************************************************/
+    void Flush()
+    {
+        Data* pdata_new = nullptr; // Copy of vector data with the staged values merged in
+		Data* pdata_old = nullptr; // Pure copy of vector data
+		std::vector<T> batch;      // Staged values the data does not hold yet
+		LFSV_STAT(std::uint64_t attempts = 0);
+		LFSV_STAT(std::uint64_t discarded = 0);
+
+		if(mode != WriteMode::Staged)
+			return;
+
+		typename Reclaimer::Guard hp(reclaimer);
+		EpochReclaimer::Guard sg(stage->staging);
+		Staged* newest = sg.Protect(stage->staged); // Everything up to here gets merged
+		if(newest == nullptr)
+			return;
+
+        do {
+			LFSV_STAT(++attempts);
+
+			// Store old pointer to ensure safe reading
+			pdata_old = hp.Protect(pdata);
+
+			// Already merged, by another flush or an earlier one
+			if(newest->seq <= pdata_old->staged)
+			{
+				if(pdata_new)
+					Reclaim(pdata_new);
+				return;
+			}
+
+			batch.clear();
+			for(Staged* node = newest; node != nullptr && node->seq > pdata_old->staged;
+			    node = node->next.load())
+				batch.push_back(node->value);
+			std::sort(batch.begin(), batch.end(), comp);
+
+			// Reuse the copy from the previous attempt as scratch space
+			if(pdata_new)
+			{
+				pdata_new->clear();
+				LFSV_STAT(++discarded);
+			}
+			else
+				pdata_new = new (bank.get()) Data(alloc, &pool);
+
+			pdata_new->reserve(pdata_old->size() + batch.size());
+			std::merge(pdata_old->begin(), pdata_old->end(), batch.begin(), batch.end(),
+			           std::back_inserter(*pdata_new), comp);
+			pdata_new->staged = newest->seq;
+        } while ( !(this->pdata).compare_exchange_weak(pdata_old, pdata_new));
+
+		hp.Clear();
+		Retire(pdata_old);
+		stage->stagedCount.fetch_sub(static_cast<std::ptrdiff_t>(batch.size()), std::memory_order_relaxed);
+		LFSV_STAT(CountWrite(batch.size(), attempts, discarded));
+
+		Trim(sg, newest->seq);
+    }
+
+    /*!******************************************************************
+      \brief
+        Return the value at a specific index within the vector.
+
+      \param pos
+        The index within the vector to pull a value from.
+
+      \return
+        The value at the specified position within the vector.
+    ********************************************************************/
+    T operator[](std::size_t pos) 
+    {
+		LFSV_TRACE(Trace(TraceEvent::ReadBegin));
+
+        if(mode == WriteMode::Staged)
+        {
+            if(consistency == ReadConsistency::Merge)
+            {
+                T ret_val = ReadStaged(pos);
+                LFSV_TRACE(Trace(TraceEvent::ReadEnd));
+                return ret_val;
+            }
+            Flush();
+        }
+
+		Data* pdata_old; // Pure copy of vector data
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+        // Protect the current pointer to ensure safe reading
+        pdata_old = hp.Protect(pdata);
+
+		T ret_val = (*pdata_old)[pos]; // Read value at given position
+
+		hp.Clear();
+		LFSV_TRACE(Trace(TraceEvent::ReadEnd));
+
+        return ret_val;
+    }
+
+    /*!******************************************************************
+      \brief
+        Return the # of replaced versions that have been retired but not
+        yet reclaimed.
+
+      \return
+        The # of versions waiting on the reclaimer.
+    ********************************************************************/
+    std::size_t Unreclaimed() const
+    {
+        return reclaimer.Unreclaimed();
+    }
+
+    /*!******************************************************************
+      \brief
+        Return a snapshot of the statistics counters, summed across
+        every thread. The counters are only kept when LFSV_STATS is
+        defined; otherwise the snapshot is empty and enabled is false.
+
+      \return
+        The aggregated counters.
+    ********************************************************************/
+    LFSVStats Stats() const
+    {
+        LFSVStats stats;
+#ifdef LFSV_STATS
+        stats.enabled = true;
+        writeStats.ForEach([&stats](WriteCounters const& counters)
+        {
+            stats.inserts += counters.inserts.load(std::memory_order_relaxed);
+            stats.casFailures += counters.casFailures.load(std::memory_order_relaxed);
+            stats.erased += counters.erased.load(std::memory_order_relaxed);
+            stats.discarded += counters.discarded.load(std::memory_order_relaxed);
+        });
+        stats.reclaim = reclaimer.Stats();
+        stats.bank = bank.Stats();
+#endif
+        return stats;
     }
 };
 
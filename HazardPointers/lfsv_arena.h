@@ -0,0 +1,457 @@
+/******************************************************************************/
+/*!
+\file   lfsv_arena.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the definition of the Arena class and the
+	ArenaAllocator class, an optional storage backend that places each
+	LFSV version's array inside one reserved, huge-page backed region of
+	virtual memory. Use it as the Allocator of an LFSV:
+
+	    LFSV<int, std::less<int>, ArenaAllocator<int>> container;
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include "lfsv.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, madvise, munmap
+#include <unistd.h>   // sysconf
+#endif
+
+/**************************************************************************/
+/*!
+  \class Arena
+  \brief
+    A reserved region of virtual memory that blocks are carved out of
+	with a bump pointer. Freed blocks are kept in power-of-two size-class
+	bins for reuse, and the whole region is released in one go when the
+	arena is destroyed. The region is aligned to, and advised for,
+	transparent huge pages where the kernel supports them, so copying a
+	large array walks far fewer TLB entries.
+
+	Requests the region cannot satisfy (or every request, on platforms
+	without mmap) fall back to the global heap, and are told apart on
+	release by their address.
+
+	Binned blocks of two pages or more are released in bulk: once enough
+	of them have piled up since the last trim, the whole pages inside
+	them are handed back to the kernel, so a container that shrinks (or
+	is destroyed) doesn't leave its peak footprint resident.
+
+    Non-Core Operations Include:
+
+    -Allocates a block of at least a given # of bytes.
+	-Returns a block to its size-class bin.
+	-Hands the physical memory behind binned blocks back to the kernel.
+	-Returns the # of bytes reserved and carved out so far.
+
+*/
+/**************************************************************************/
+class Arena
+{
+	static const std::size_t minBlock = 64;         // Size of the smallest block, in bytes
+	static const std::size_t hugePage = 2u << 20;   // Alignment of the region, in bytes
+	static const unsigned classes = 40;             // # of size classes; each doubles the last
+
+	char* mapping;                  // Start of the whole mapping, for munmap
+	std::size_t mapped;             // Size of the whole mapping
+	char* base;                     // Start of the huge-page aligned region
+	std::size_t reserved;           // Size of the region
+	std::size_t used;               // # of bytes carved out of the region so far
+	std::size_t carved;             // # of large blocks carved out so far
+	std::size_t page;               // Size of a page, in bytes
+	std::size_t trimAfter;          // Untrimmed binned bytes that trigger a trim; 0 for never
+	std::size_t untrimmed;          // Bytes binned since the last trim, in trimmable blocks
+
+	std::mutex mutex;               // Guards used, bins and the trim counts; only taken on pool misses
+	std::vector<void*> bins[classes]; // Freed blocks, by size class
+	std::size_t trimmed[classes];   // # of blocks at the bottom of each bin already trimmed
+
+	/*!******************************************************************
+      \brief
+        Returns the size class able to hold a given # of bytes.
+
+	  \param bytes
+	  	The # of bytes.
+
+	  \return
+	  	The size class, or classes if the request is too large to bin.
+    ********************************************************************/
+	static unsigned ClassOf(std::size_t bytes)
+	{
+		unsigned c = 0;
+		while(c < classes && (minBlock << c) < bytes)
+			++c;
+		return c;
+	}
+
+	/*!******************************************************************
+      \brief
+        Checks whether a block was carved out of the region.
+
+	  \param block
+	  	The block to check.
+
+	  \return
+	  	Whether the block lives within the region.
+    ********************************************************************/
+	bool Owns(void const* block) const
+	{
+		char const* address = static_cast<char const*>(block);
+		return base != nullptr && address >= base && address < base + reserved;
+	}
+
+	/*!******************************************************************
+      \brief
+        Checks whether blocks of a size class are worth trimming: they
+		must span at least two pages to be sure of holding a whole one.
+
+	  \param size
+	  	The size of the class's blocks.
+
+	  \return
+	  	Whether Trim() releases blocks of this size.
+    ********************************************************************/
+	bool Trimmable(std::size_t size) const
+	{
+		return size >= 2 * page;
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands the whole pages inside every binned block not yet trimmed
+		back to the kernel. Blocks are only 64-byte aligned, so each range
+		is rounded inward to page boundaries, never touching a neighbor.
+		The mutex must be held.
+
+	  \return
+	  	The # of bytes released.
+    ********************************************************************/
+	std::size_t TrimLocked()
+	{
+		std::size_t released = 0;
+#if defined(__unix__) || defined(__APPLE__)
+		for(unsigned c = 0; c < classes; ++c)
+		{
+			std::size_t size = minBlock << c;
+			if(!Trimmable(size))
+				continue;
+
+			for(std::size_t i = trimmed[c]; i < bins[c].size(); ++i)
+			{
+				std::uintptr_t start = reinterpret_cast<std::uintptr_t>(bins[c][i]);
+				std::uintptr_t end = (start + size) / page * page;
+				start = (start + page - 1) / page * page;
+				if(madvise(reinterpret_cast<void*>(start), end - start, MADV_DONTNEED) == 0)
+					released += end - start;
+			}
+			trimmed[c] = bins[c].size();
+		}
+#endif
+		untrimmed = 0;
+		return released;
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the Arena class. Reserves address space only;
+		physical memory is committed as blocks are first written.
+
+	  \param bytes
+	  	The size of the region to reserve.
+
+	  \param trimBytes
+	  	How many bytes of freed blocks may pile up in the bins before
+		they are trimmed automatically; 0 leaves trimming to Trim().
+    ********************************************************************/
+	explicit Arena(std::size_t bytes = std::size_t(1) << 30, std::size_t trimBytes = std::size_t(64) << 20)
+		: mapping(nullptr), mapped(0), base(nullptr), reserved(0), used(0), carved(0), page(4096),
+		  trimAfter(trimBytes), untrimmed(0), mutex(), bins(), trimmed()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		long pageSize = sysconf(_SC_PAGESIZE);
+		if(pageSize > 0)
+			page = static_cast<std::size_t>(pageSize);
+
+		std::size_t size = (bytes + hugePage - 1) / hugePage * hugePage;
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+		flags |= MAP_NORESERVE;
+#endif
+		void* region = mmap(nullptr, size + hugePage, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if(region == MAP_FAILED)
+			return;
+
+		mapping = static_cast<char*>(region);
+		mapped = size + hugePage;
+		std::uintptr_t start = reinterpret_cast<std::uintptr_t>(mapping);
+		base = mapping + ((hugePage - start % hugePage) % hugePage);
+		reserved = size;
+#ifdef MADV_HUGEPAGE
+		madvise(base, reserved, MADV_HUGEPAGE);
+#endif
+#else
+		(void)bytes;
+#endif
+	}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the Arena class. Releases the whole region at
+		once; every block carved out of it must be dead by this point.
+    ********************************************************************/
+	~Arena()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		if(mapping)
+			munmap(mapping, mapped);
+#endif
+	}
+
+	Arena(Arena const&) = delete;
+	Arena& operator=(Arena const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Allocates a block of at least a given # of bytes, reusing a
+		binned block of the same size class when there is one.
+
+	  \param bytes
+	  	The # of bytes needed.
+
+	  \return
+	  	The block, aligned to at least minBlock bytes within the region.
+    ********************************************************************/
+	void* Allocate(std::size_t bytes)
+	{
+		unsigned c = ClassOf(bytes);
+		if(c < classes && base != nullptr)
+		{
+			std::size_t size = minBlock << c;
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if(!bins[c].empty())
+			{
+				void* block = bins[c].back();
+				bins[c].pop_back();
+				if(trimmed[c] > bins[c].size())
+					trimmed[c] = bins[c].size();
+				else if(Trimmable(size))
+					untrimmed -= size;
+				return block;
+			}
+			// Stagger large blocks across cache sets, so arrays that
+			// start on the same huge-page offset don't evict each other
+			std::size_t pad = size >= 4096 ? (carved % 64) * minBlock : 0;
+			if(size + pad <= reserved - used)
+			{
+				void* block = base + used + pad;
+				used += size + pad;
+				carved += size >= 4096;
+				return block;
+			}
+		}
+
+		// Out of arena space; fall back to the global heap
+		return ::operator new(bytes);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns a block to its size-class bin, or to the global heap if
+		it came from there. Trims the bins once enough freed memory has
+		piled up in them.
+
+	  \param block
+	  	The block to return.
+
+	  \param bytes
+	  	The # of bytes it was allocated with.
+    ********************************************************************/
+	void Deallocate(void* block, std::size_t bytes)
+	{
+		if(!Owns(block))
+		{
+			::operator delete(block);
+			return;
+		}
+
+		unsigned c = ClassOf(bytes);
+		std::size_t size = minBlock << c;
+		std::lock_guard<std::mutex> lock(mutex);
+		bins[c].push_back(block);
+
+		if(Trimmable(size))
+		{
+			untrimmed += size;
+			if(trimAfter != 0 && untrimmed >= trimAfter)
+				TrimLocked();
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Hands the physical memory behind every binned block of two pages
+		or more back to the kernel. The blocks stay reserved and binned,
+		and are committed again (zeroed) when next written.
+
+	  \return
+	  	The # of bytes released by this call.
+    ********************************************************************/
+	std::size_t Trim()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return TrimLocked();
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the size of the reserved region.
+
+	  \return
+	  	The # of bytes reserved, or 0 if every request uses the heap.
+    ********************************************************************/
+	std::size_t Reserved() const
+	{
+		return reserved;
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns how much of the region has been carved into blocks.
+
+	  \return
+	  	The # of bytes carved out so far.
+    ********************************************************************/
+	std::size_t Used()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return used;
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class ArenaAllocator
+  \brief
+    A standard allocator that takes its memory from a shared Arena.
+	Copies (and rebound copies) share the same arena, which lives until
+	the last of them is destroyed.
+
+    Non-Core Operations Include:
+
+    -Allocates an array of T within the arena.
+	-Returns an array of T to the arena.
+	-Returns the arena.
+
+*/
+/**************************************************************************/
+template <typename T>
+class ArenaAllocator
+{
+	static_assert(alignof(T) <= 64, "ArenaAllocator: blocks are only 64-byte aligned");
+
+	template <typename U> friend class ArenaAllocator;
+
+	std::shared_ptr<Arena> arena; // The arena shared by every copy
+
+	public:
+
+	typedef T value_type;
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ArenaAllocator class. Reserves a new arena of
+		the default size.
+    ********************************************************************/
+	ArenaAllocator() : arena(std::make_shared<Arena>())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ArenaAllocator class that uses an existing
+		arena, so several containers can share one region.
+
+	  \param shared
+	  	The arena to allocate from.
+    ********************************************************************/
+	explicit ArenaAllocator(std::shared_ptr<Arena> shared) : arena(std::move(shared))
+	{}
+
+	/*!******************************************************************
+      \brief
+        Rebinding constructor for the ArenaAllocator class.
+
+	  \param other
+	  	The allocator whose arena should be shared.
+    ********************************************************************/
+	template <typename U>
+	ArenaAllocator(ArenaAllocator<U> const& other) : arena(other.arena)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Allocates an uninitialized array of T within the arena.
+
+	  \param n
+	  	The # of values the array must hold.
+
+	  \return
+	  	The array.
+    ********************************************************************/
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(arena->Allocate(n * sizeof(T)));
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns an array of T to the arena.
+
+	  \param pointer
+	  	The array, with every value already destroyed.
+
+	  \param n
+	  	The # of values it was allocated with.
+    ********************************************************************/
+	void deallocate(T* pointer, std::size_t n)
+	{
+		arena->Deallocate(pointer, n * sizeof(T));
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the arena this allocator takes its memory from.
+
+	  \return
+	  	The arena.
+    ********************************************************************/
+	Arena& GetArena() const
+	{
+		return *arena;
+	}
+
+	template <typename U>
+	bool operator==(ArenaAllocator<U> const& other) const
+	{
+		return arena == other.arena;
+	}
+
+	template <typename U>
+	bool operator!=(ArenaAllocator<U> const& other) const
+	{
+		return arena != other.arena;
+	}
+};
@@ -0,0 +1,518 @@
+/******************************************************************************/
+/*!
+\file   lfsv_bench.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains a small benchmark driver comparing the flat LFSV
+	against the chunked ChunkedLFSV, the range-sharded ShardedLFSV, an LFSV
+	whose arrays live in a huge-page Arena and batched flat inserts, times
+	indexed reads against snapshot reads and rank queries against
+	client-side binary searches, compares the flat LFSV against the
+	compressed PackedLFSV on clustered values, then
+	compares the plain CAS write path against combining and staged writers
+	as the thread count grows. Finally, runs readers alongside writers once per
+	reclamation policy, and fills thousands of small containers at once
+	with a hazard domain per container and with one shared domain.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_bench.cpp -o lfsv_bench
+	Usage:      lfsv_bench [values] [threads]
+
+*/
+/******************************************************************************/
+
+#include "lfsv.h"
+#include "lfsv_chunked.h"
+#include "lfsv_arena.h"
+#include "lfsv_sharded.h"
+#include "lfsv_packed.h"
+#include <chrono>  // std::chrono
+#include <cstdlib> // std::atoi
+#include <random>  // std::mt19937
+#include <algorithm> // std::shuffle
+
+/*!******************************************************************
+  \brief
+    Inserts a batch of random values from several threads and checks
+	that the container ends up sorted.
+
+  \param name
+	Label to print alongside the results.
+
+  \param values
+	Total # of values to insert.
+
+  \param threads
+	# of writer threads to split the values between.
+
+  \param args
+	Arguments forwarded to the container's constructor.
+********************************************************************/
+template <typename Container, typename... Args>
+void RunInserts(char const* name, int values, int threads, Args... args)
+{
+	Container container(args...);
+	std::vector<std::thread> workers;
+	int perThread = values / threads;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&container, perThread, t]()
+		{
+			std::mt19937 rng(t + 1);
+			for(int i = 0; i < perThread; ++i)
+				container.Insert(static_cast<int>(rng() % 1000000));
+		});
+	}
+	for(std::thread& worker : workers)
+		worker.join();
+	auto end = std::chrono::steady_clock::now();
+
+	// Verify the final contents are in order
+	bool sorted = true;
+	for(int i = 1; i < perThread * threads; ++i)
+		if(container[i - 1] > container[i])
+			sorted = false;
+
+	std::cout << name << ": "
+	          << std::chrono::duration<double, std::milli>(end - start).count()
+	          << " ms for " << perThread * threads << " inserts on "
+	          << threads << " thread(s)" << (sorted ? "" : " [NOT SORTED]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Inserts random values through LFSV::InsertBatch in fixed-size bursts
+	from several threads and checks that the container ends up sorted.
+
+  \param values
+	Total # of values to insert.
+
+  \param threads
+	# of writer threads to split the values between.
+
+  \param burst
+	# of values handed to each InsertBatch call.
+********************************************************************/
+void RunBatches(int values, int threads, int burst)
+{
+	LFSV<> container;
+	std::vector<std::thread> workers;
+	int perThread = values / threads / burst * burst;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&container, perThread, burst, t]()
+		{
+			std::mt19937 rng(t + 1);
+			std::vector<int> batch(burst);
+			for(int i = 0; i < perThread; i += burst)
+			{
+				for(int& value : batch)
+					value = static_cast<int>(rng() % 1000000);
+				container.InsertBatch(batch.data(), batch.size());
+			}
+		});
+	}
+	for(std::thread& worker : workers)
+		worker.join();
+	auto end = std::chrono::steady_clock::now();
+
+	bool sorted = true;
+	for(int i = 1; i < perThread * threads; ++i)
+		if(container[i - 1] > container[i])
+			sorted = false;
+
+	std::cout << "batch  : "
+	          << std::chrono::duration<double, std::milli>(end - start).count()
+	          << " ms for " << perThread * threads << " inserts on "
+	          << threads << " thread(s), " << burst << " per batch"
+	          << (sorted ? "" : " [NOT SORTED]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Compares loading a large unsorted set with one InsertBatch call,
+	sorted on the calling thread, against the bulk-load constructor,
+	sorted across a pool of threads.
+
+  \param values
+	# of values to load.
+
+  \param threads
+	# of threads for the bulk load to sort with.
+********************************************************************/
+void RunBulk(int values, int threads)
+{
+	std::mt19937 rng(1);
+	std::vector<int> input(values);
+	for(int& value : input)
+		value = static_cast<int>(rng());
+
+	auto start = std::chrono::steady_clock::now();
+	LFSV<> batched;
+	batched.InsertBatch(input.data(), input.size());
+	auto middle = std::chrono::steady_clock::now();
+	LFSV<> bulk(input.data(), input.size(), threads);
+	auto end = std::chrono::steady_clock::now();
+
+	LFSV<>::Snapshot left = batched.GetSnapshot();
+	LFSV<>::Snapshot right = bulk.GetSnapshot();
+	bool same = left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+
+	std::cout << "bulk   : "
+	          << std::chrono::duration<double, std::milli>(middle - start).count()
+	          << " ms batched vs "
+	          << std::chrono::duration<double, std::milli>(end - middle).count()
+	          << " ms bulk loaded, " << values << " values on " << threads << " thread(s)"
+	          << (same ? "" : " [MISMATCH]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Compares a full scan through LFSV::operator[] against the same scan
+	through a single pinned LFSV::Snapshot.
+
+  \param values
+	# of values to fill the container with.
+********************************************************************/
+void RunReads(int values)
+{
+	LFSV<> container;
+	std::vector<int> fill(values);
+	std::mt19937 rng(1);
+	for(int& value : fill)
+		value = static_cast<int>(rng() % 1000000);
+	container.InsertBatch(fill.data(), fill.size());
+
+	long long indexSum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < values; ++i)
+		indexSum += container[i];
+	auto middle = std::chrono::steady_clock::now();
+
+	long long snapshotSum = 0;
+	{
+		LFSV<>::Snapshot snapshot = container.GetSnapshot();
+		for(int value : snapshot)
+			snapshotSum += value;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << "reads  : operator[] "
+	          << std::chrono::duration<double, std::milli>(middle - start).count()
+	          << " ms, snapshot "
+	          << std::chrono::duration<double, std::milli>(end - middle).count()
+	          << " ms for " << values << " values"
+	          << (indexSum == snapshotSum ? "" : " [MISMATCH]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Inserts clustered values (small random gaps, shuffled) into a flat
+	LFSV and a PackedLFSV from several threads, and compares time taken
+	and bytes held.
+
+  \param values
+	Total # of values to insert.
+
+  \param threads
+	# of threads to split the values between.
+********************************************************************/
+void RunPacked(int values, int threads)
+{
+	std::vector<int> clustered(values);
+	std::mt19937 rng(1);
+	int next = 0;
+	for(int& value : clustered)
+		value = next += static_cast<int>(rng() % 8);
+	std::shuffle(clustered.begin(), clustered.end(), rng);
+
+	LFSV<> flat;
+	PackedLFSV<> packed;
+	auto fill = [&clustered, values, threads](auto& container)
+	{
+		std::vector<std::thread> workers;
+		int perThread = values / threads;
+		auto start = std::chrono::steady_clock::now();
+		for(int t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&container, &clustered, perThread, t]()
+			{
+				for(int i = t * perThread; i < (t + 1) * perThread; ++i)
+					container.Insert(clustered[i]);
+			});
+		}
+		for(std::thread& worker : workers)
+			worker.join();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	double flatMillis = fill(flat);
+	double packedMillis = fill(packed);
+	std::cout << "packed : flat " << flatMillis << " ms, "
+	          << values / threads * threads * sizeof(int) / 1024 << " KiB; packed "
+	          << packedMillis << " ms, " << packed.Bytes() / 1024 << " KiB for "
+	          << values / threads * threads << " clustered values on " << threads << " thread(s)"
+	          << (flat.GetSnapshot().size() == packed.size() ? "" : " [MISMATCH]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Times rank queries answered by a client-side binary search over
+	operator[] (one hazard acquire per probe) against Snapshot::Rank(),
+	on the flat LFSV and on the ChunkedLFSV.
+
+  \param values
+	# of values to fill each container with.
+
+  \param queries
+	# of rank queries to run.
+********************************************************************/
+void RunRanks(int values, int queries)
+{
+	LFSV<> flat;
+	ChunkedLFSV<> chunked;
+	std::mt19937 rng(1);
+	for(int i = 0; i < values; ++i)
+	{
+		int value = static_cast<int>(rng() % 1000000);
+		flat.Insert(value);
+		chunked.Insert(value);
+	}
+
+	std::vector<int> keys(queries);
+	for(int& key : keys)
+		key = static_cast<int>(rng() % 1000000);
+
+	std::size_t probeSum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for(int v : keys)
+	{
+		std::size_t low = 0;
+		std::size_t high = static_cast<std::size_t>(values);
+		while(low < high)
+		{
+			std::size_t mid = (low + high) / 2;
+			if(flat[mid] < v)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		probeSum += low;
+	}
+	auto probed = std::chrono::steady_clock::now();
+
+	std::size_t flatSum = 0;
+	for(int v : keys)
+		flatSum += flat.GetSnapshot().Rank(v);
+	auto flatDone = std::chrono::steady_clock::now();
+
+	std::size_t chunkedSum = 0;
+	for(int v : keys)
+		chunkedSum += chunked.GetSnapshot().Rank(v);
+	auto end = std::chrono::steady_clock::now();
+
+	auto perQuery = [queries](std::chrono::steady_clock::duration spent)
+	{
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(spent).count()) / queries;
+	};
+	std::cout << "ranks  : operator[] search " << perQuery(probed - start)
+	          << " ns, flat snapshot " << perQuery(flatDone - probed)
+	          << " ns, chunked snapshot " << perQuery(end - flatDone)
+	          << " ns per query over " << values << " values"
+	          << (probeSum == flatSum && flatSum == chunkedSum ? "" : " [MISMATCH]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Runs reader threads against writer threads on an LFSV using a given
+	reclamation policy, and reports mean read latency, write throughput
+	and the peak # of retired versions waiting to be reclaimed.
+
+  \param name
+	Label to print alongside the results.
+
+  \param values
+	Total # of values to insert.
+
+  \param writers
+	# of writer threads to split the values between.
+
+  \param readers
+	# of reader threads reading while the writers run.
+********************************************************************/
+template <typename Reclaimer>
+void RunReclaimer(char const* name, int values, int writers, int readers)
+{
+	typedef LFSV<int, std::less<int>, std::allocator<int>, Reclaimer> Container;
+	const int readBatch = 256; // # of reads timed together
+
+	Container container;
+	int perThread = values / writers;
+	container.Insert(0); // Readers always have a value to read
+
+	std::atomic<int> writing(writers);
+	std::atomic<long long> readCount(0);
+	std::atomic<long long> readNanos(0);
+	std::atomic<long long> readSum(0);
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int t = 0; t < writers; ++t)
+	{
+		workers.emplace_back([&container, &writing, perThread, t]()
+		{
+			std::mt19937 rng(t + 1);
+			for(int i = 0; i < perThread; ++i)
+				container.Insert(static_cast<int>(rng() % 1000000));
+			writing.fetch_sub(1);
+		});
+	}
+	for(int t = 0; t < readers; ++t)
+	{
+		workers.emplace_back([&container, &writing, &readCount, &readNanos, &readSum, readBatch]()
+		{
+			long long count = 0;
+			long long sum = 0;
+			std::chrono::steady_clock::duration spent(0);
+			while(writing.load(std::memory_order_relaxed) > 0)
+			{
+				auto begin = std::chrono::steady_clock::now();
+				for(int i = 0; i < readBatch; ++i)
+					sum += container[0];
+				spent += std::chrono::steady_clock::now() - begin;
+				count += readBatch;
+			}
+			readCount.fetch_add(count);
+			readNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(spent).count());
+			readSum.fetch_add(sum); // Keeps the reads from being optimized away
+		});
+	}
+
+	// Sample the retired backlog while the writers run
+	std::size_t peak = 0;
+	while(writing.load() > 0)
+	{
+		peak = std::max(peak, container.Unreclaimed());
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+	auto end = std::chrono::steady_clock::now();
+	for(std::thread& worker : workers)
+		worker.join();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	long long reads = readCount.load();
+	std::cout << name << ": "
+	          << (reads ? static_cast<double>(readNanos.load()) / reads : 0.0) << " ns/read, "
+	          << perThread * writers / seconds / 1000.0 << "k inserts/s, peak "
+	          << peak << " unreclaimed version(s) (<= "
+	          << peak * perThread * writers * sizeof(int) / 1024 << " KiB) with "
+	          << writers << " writer(s), " << readers << " reader(s)" << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Builds many small containers at once, one per tenant, and has
+	several threads spread inserts across all of them. Shows what each
+	container costs to create, use and destroy under a reclamation
+	policy.
+
+  \param name
+	Label for the output line.
+
+  \param tenants
+	# of containers.
+
+  \param values
+	# of values inserted into each container.
+
+  \param threads
+	# of threads inserting.
+********************************************************************/
+template <typename Reclaimer>
+void RunTenants(char const* name, int tenants, int values, int threads)
+{
+	typedef LFSV<int, std::less<int>, std::allocator<int>, Reclaimer> Container;
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::vector<std::unique_ptr<Container>> containers;
+		for(int i = 0; i < tenants; ++i)
+			containers.emplace_back(new Container());
+
+		std::vector<std::thread> workers;
+		for(int t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&containers, tenants, values, threads, t]()
+			{
+				std::mt19937 rng(t + 1);
+				for(int i = 0; i < values * tenants / threads; ++i)
+					containers[rng() % tenants]->Insert(static_cast<int>(rng() % 1000000));
+			});
+		}
+		for(std::thread& worker : workers)
+			worker.join();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << name << ": " << std::chrono::duration<double, std::milli>(end - start).count()
+	          << " ms to create, fill and destroy " << tenants << " containers of "
+	          << values << " value(s) from " << threads << " thread(s)" << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Entry point for the benchmark driver.
+
+  \param argc
+	# of command line arguments.
+
+  \param argv
+	Command line arguments: [values] [threads].
+
+  \return
+	0 on success.
+********************************************************************/
+int main(int argc, char* argv[])
+{
+	int values = argc > 1 ? std::atoi(argv[1]) : 20000;
+	int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+
+	RunInserts<LFSV<>>("flat   ", values, threads);
+	RunInserts<ChunkedLFSV<>>("chunked", values, threads);
+	RunInserts<ShardedLFSV<>>("sharded", values, threads);
+	RunInserts<LFSV<int, std::less<int>, ArenaAllocator<int>>>("arena  ", values, threads);
+	RunBatches(values, threads, 100);
+	RunBulk(values * 50, threads);
+	RunReads(values * 10);
+	RunRanks(values * 10, 100000);
+	RunPacked(values * 5, threads);
+
+	// Throughput vs. thread count for the plain CAS loop, combining and staged writers
+	for(int count = 1; count <= 16; count *= 2)
+	{
+		RunInserts<LFSV<>>("cas    ", values, count, WriteMode::CAS);
+		RunInserts<LFSV<>>("combine", values, count, WriteMode::Combining);
+		RunInserts<LFSV<>>("staged ", values, count, WriteMode::Staged);
+	}
+
+	// Read latency, write throughput and memory held back, per reclamation policy
+	RunReclaimer<HazardReclaimer>("hazard ", values, threads, threads);
+	RunReclaimer<EpochReclaimer>("epoch  ", values, threads, threads);
+	RunReclaimer<SharedHazardReclaimer>("shared ", values, threads, threads);
+
+	// Many small containers: a domain per container vs. one for the process
+	RunTenants<HazardReclaimer>("hazard ", 2000, 16, threads);
+	RunTenants<SharedHazardReclaimer>("shared ", 2000, 16, threads);
+
+	return 0;
+}
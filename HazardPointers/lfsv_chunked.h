@@ -0,0 +1,802 @@
+/******************************************************************************/
+/*!
+\file   lfsv_chunked.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the definition of the ChunkedLFSV class template, a variant
+	of LFSV that stores its data in a persistent tree of fixed-size sorted
+	chunks. An insert copies only the path from the root down to the
+	affected chunk, and the new root is published with a single CAS.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include "lfsv.h"
+
+const unsigned chunkSize = 64;   // Max # of values held by a leaf chunk
+const unsigned chunkFanout = 16; // Max # of children held by a branch
+
+/**************************************************************************/
+/*!
+  \struct ChunkNode
+  \brief
+    Common header of every node within a ChunkedLFSV tree. Nodes are
+	immutable once published and may be shared by several versions of
+	the tree, so each one carries a reference count of the parents and
+	versions that still point to it.
+
+*/
+/**************************************************************************/
+struct ChunkNode
+{
+	std::atomic<int> refs; // # of parents/versions that reference this node
+	bool leaf;             // Whether this node is a ChunkLeaf or a ChunkBranch
+	unsigned count;        // # of values (leaf) or children (branch) in use
+	std::size_t size;      // Total # of values stored beneath this node
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ChunkNode struct.
+
+	  \param isLeaf
+	  	Whether the node being built is a leaf chunk.
+    ********************************************************************/
+	explicit ChunkNode(bool isLeaf) : refs(1), leaf(isLeaf), count(0), size(0)
+	{}
+};
+
+/**************************************************************************/
+/*!
+  \struct ChunkLeaf
+  \brief
+    A leaf of the tree, holding a small sorted run of values and their
+	sum.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct ChunkLeaf : ChunkNode
+{
+	T values[chunkSize];             // Sorted values held by this chunk
+	typename ValueSum<T>::type sum{}; // Sum of the values, if they are arithmetic
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ChunkLeaf struct.
+    ********************************************************************/
+	ChunkLeaf() : ChunkNode(true)
+	{}
+};
+
+/**************************************************************************/
+/*!
+  \struct ChunkBranch
+  \brief
+    An inner node of the tree. Keeps the lowest value, size and sum of
+	every child, so inserts can be routed and order statistics answered
+	without touching the children themselves.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct ChunkBranch : ChunkNode
+{
+	ChunkNode* children[chunkFanout];              // Subtrees, in sorted order
+	T lows[chunkFanout];                           // Lowest value held by each subtree
+	std::size_t sizes[chunkFanout];                // # of values held by each subtree
+	typename ValueSum<T>::type sums[chunkFanout];  // Sum of the values held by each subtree
+	typename ValueSum<T>::type sum{};              // Sum of every subtree's values
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ChunkBranch struct.
+    ********************************************************************/
+	ChunkBranch() : ChunkNode(false)
+	{}
+};
+
+/**************************************************************************/
+/*!
+  \class ChunkedLFSV
+  \brief
+    A lock-free implementation of an automatically-sorting vector, backed
+	by a persistent tree of sorted chunks. Sorts elements from least to
+	greatest according to Compare. Replaced roots are handed to
+	Reclaimer, which decides when they are safe to release.
+
+    Non-Core Operations Include:
+
+    -Insert a new value into the vector.
+    -Return the value at a specific index within the vector.
+	-Return the number of values within the vector.
+	-Pin the current version of the tree for order-statistic queries.
+	-Hand an old/replaced root to the reclaimer.
+
+*/
+/**************************************************************************/
+template <typename T = int, typename Compare = std::less<T>, typename Reclaimer = HazardReclaimer>
+class ChunkedLFSV
+{
+	typedef ChunkLeaf<T> Leaf;     // Leaf chunks of this tree
+	typedef ChunkBranch<T> Branch; // Inner nodes of this tree
+	typedef typename ValueSum<T>::type Sum; // What values are summed in
+
+	Compare comp;                 // Ordering of the values
+	Reclaimer reclaimer;          // Decides when replaced roots may be released
+	std::atomic<ChunkNode*> root; // The current version of the tree
+
+	public:
+
+	/*!******************************************************************
+      \brief
+		Adds a reference to a node that is about to be shared.
+
+	  \param node
+	  	The node to share.
+
+	  \return
+	  	The same node, for convenience.
+    ********************************************************************/
+	static ChunkNode* Acquire(ChunkNode* node)
+	{
+		node->refs.fetch_add(1, std::memory_order_relaxed);
+		return node;
+	}
+
+	/*!******************************************************************
+      \brief
+		Drops a reference to a node, deleting it (and releasing its
+		children) once nothing refers to it anymore.
+
+	  \param node
+	  	The node to release.
+    ********************************************************************/
+	static void Release(ChunkNode* node)
+	{
+		if(node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		if(node->leaf)
+			delete static_cast<Leaf*>(node);
+		else
+		{
+			Branch* branch = static_cast<Branch*>(node);
+			for(unsigned i = 0; i < branch->count; ++i)
+				Release(branch->children[i]);
+			delete branch;
+		}
+	}
+
+	private:
+
+	/*!******************************************************************
+      \brief
+		Returns the lowest value held beneath a node.
+
+	  \param node
+	  	The (non-empty) node to inspect.
+
+	  \return
+	  	The lowest value beneath the node.
+    ********************************************************************/
+	static T const& Low(ChunkNode const* node)
+	{
+		if(node->leaf)
+			return static_cast<Leaf const*>(node)->values[0];
+		return static_cast<Branch const*>(node)->lows[0];
+	}
+
+	/*!******************************************************************
+      \brief
+		Returns the sum of the values held beneath a node.
+
+	  \param node
+	  	The node to inspect.
+
+	  \return
+	  	The cached sum.
+    ********************************************************************/
+	static Sum const& SumOf(ChunkNode const* node)
+	{
+		if(node->leaf)
+			return static_cast<Leaf const*>(node)->sum;
+		return static_cast<Branch const*>(node)->sum;
+	}
+
+	/*!******************************************************************
+      \brief
+		Fills a fresh leaf with a sorted run of values and updates its
+		cached size and sum.
+
+	  \param leaf
+	  	The leaf to fill.
+
+	  \param values
+	  	The values to place into the leaf.
+
+	  \param count
+	  	The # of values to place into the leaf.
+    ********************************************************************/
+	static void FillLeaf(Leaf* leaf, T const* values, unsigned count)
+	{
+		std::copy(values, values + count, leaf->values);
+		leaf->count = count;
+		leaf->size = count;
+		if constexpr (std::is_arithmetic<T>::value)
+		{
+			leaf->sum = 0;
+			for(unsigned i = 0; i < count; ++i)
+				leaf->sum += values[i];
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+		Counts the values beneath a node that are less than v, adding
+		them up along the way if asked to. Whole subtrees to the left
+		are taken from their parent's cached sizes and sums, so only
+		one chunk is searched.
+
+	  \param node
+	  	The node to count beneath.
+
+	  \param v
+	  	The value to count up to.
+
+	  \param comp
+	  	The ordering of the values.
+
+	  \param sum
+	  	Added to with the sum of the values counted; may be nullptr.
+
+	  \return
+	  	The # of values less than v.
+    ********************************************************************/
+	static std::size_t CountBelow(ChunkNode const* node, T const& v, Compare const& comp, Sum* sum)
+	{
+		std::size_t count = 0;
+		while(!node->leaf)
+		{
+			Branch const* branch = static_cast<Branch const*>(node);
+
+			// Children before the last one starting below v lie wholly below it
+			unsigned idx = static_cast<unsigned>(
+				std::lower_bound(branch->lows, branch->lows + branch->count, v, comp) - branch->lows);
+			if(idx == 0)
+				return count;
+
+			for(unsigned i = 0; i + 1 < idx; ++i)
+			{
+				count += branch->sizes[i];
+				if constexpr (std::is_arithmetic<T>::value)
+					if(sum)
+						*sum += branch->sums[i];
+			}
+			node = branch->children[idx - 1];
+		}
+
+		Leaf const* leaf = static_cast<Leaf const*>(node);
+		unsigned n = static_cast<unsigned>(
+			std::lower_bound(leaf->values, leaf->values + leaf->count, v, comp) - leaf->values);
+		if constexpr (std::is_arithmetic<T>::value)
+			if(sum)
+				for(unsigned i = 0; i < n; ++i)
+					*sum += leaf->values[i];
+		return count + n;
+	}
+
+	/*!******************************************************************
+      \brief
+		Returns the value at a specific index beneath a node, walking
+		down by the cached subtree sizes.
+
+	  \param node
+	  	The node to search beneath.
+
+	  \param index
+	  	The index of the value; must be below the node's size.
+
+	  \return
+	  	The value.
+    ********************************************************************/
+	static T const& At(ChunkNode const* node, std::size_t index)
+	{
+		while(!node->leaf)
+		{
+			Branch const* branch = static_cast<Branch const*>(node);
+			unsigned i = 0;
+			while(i + 1 < branch->count && index >= branch->sizes[i])
+				index -= branch->sizes[i++];
+			node = branch->children[i];
+		}
+		return static_cast<Leaf const*>(node)->values[index];
+	}
+
+	/*!******************************************************************
+      \brief
+		Builds a new leaf holding the values of an existing leaf plus
+		one more value. Splits the result in two if it overflows.
+
+	  \param node
+	  	The leaf to copy.
+
+	  \param v
+	  	The value to insert.
+
+	  \param split
+	  	Set to the new right-hand sibling if a split occurred.
+
+	  \return
+	  	The new (left-hand) leaf.
+    ********************************************************************/
+	ChunkNode* CopyLeaf(Leaf const* node, T const& v, ChunkNode*& split) const
+	{
+		T merged[chunkSize + 1];
+		unsigned total = node->count + 1;
+
+		// Copy prefix, new value, then suffix in one pass
+		unsigned pos = static_cast<unsigned>(
+			std::lower_bound(node->values, node->values + node->count, v, comp) - node->values);
+		std::copy(node->values, node->values + pos, merged);
+		merged[pos] = v;
+		std::copy(node->values + pos, node->values + node->count, merged + pos + 1);
+
+		Leaf* left = new Leaf();
+		if(total <= chunkSize)
+		{
+			FillLeaf(left, merged, total);
+			split = nullptr;
+			return left;
+		}
+
+		// Overflowed, so hand the upper half to a new sibling
+		Leaf* right = new Leaf();
+		unsigned half = total / 2;
+		FillLeaf(left, merged, half);
+		FillLeaf(right, merged + half, total - half);
+		split = right;
+		return left;
+	}
+
+	/*!******************************************************************
+      \brief
+		Builds a new copy of the path from a node down to the chunk
+		that should receive a value. Untouched subtrees are shared with
+		the original.
+
+	  \param node
+	  	The node at the top of the path to copy.
+
+	  \param v
+	  	The value to insert.
+
+	  \param split
+	  	Set to the new right-hand sibling if a split occurred.
+
+	  \return
+	  	The new (left-hand) copy of the node.
+    ********************************************************************/
+	ChunkNode* CopyPath(ChunkNode const* node, T const& v, ChunkNode*& split) const
+	{
+		if(node->leaf)
+			return CopyLeaf(static_cast<Leaf const*>(node), v, split);
+
+		Branch const* branch = static_cast<Branch const*>(node);
+
+		// Route to the last child whose lowest value does not exceed v
+		unsigned idx = static_cast<unsigned>(
+			std::upper_bound(branch->lows, branch->lows + branch->count, v, comp) - branch->lows);
+		if(idx != 0)
+			--idx;
+
+		ChunkNode* childSplit = nullptr;
+		ChunkNode* child = CopyPath(branch->children[idx], v, childSplit);
+
+		// Gather the new list of children, sharing all but the copied one
+		ChunkNode* children[chunkFanout + 1];
+		unsigned total = 0;
+		for(unsigned i = 0; i < branch->count; ++i)
+		{
+			if(i != idx)
+				children[total++] = Acquire(branch->children[i]);
+			else
+			{
+				children[total++] = child;
+				if(childSplit)
+					children[total++] = childSplit;
+			}
+		}
+
+		Branch* left = new Branch();
+		if(total <= chunkFanout)
+		{
+			Fill(left, children, total);
+			split = nullptr;
+			return left;
+		}
+
+		// Overflowed, so hand the upper half to a new sibling
+		Branch* right = new Branch();
+		unsigned half = total / 2;
+		Fill(left, children, half);
+		Fill(right, children + half, total - half);
+		split = right;
+		return left;
+	}
+
+	/*!******************************************************************
+      \brief
+		Fills a fresh branch with a list of children and updates its
+		cached lows, sizes and sums.
+
+	  \param branch
+	  	The branch to fill.
+
+	  \param children
+	  	The children to place into the branch.
+
+	  \param count
+	  	The # of children to place into the branch.
+    ********************************************************************/
+	static void Fill(Branch* branch, ChunkNode* const* children, unsigned count)
+	{
+		branch->count = count;
+		branch->size = 0;
+		if constexpr (std::is_arithmetic<T>::value)
+			branch->sum = 0;
+		for(unsigned i = 0; i < count; ++i)
+		{
+			branch->children[i] = children[i];
+			branch->lows[i] = Low(children[i]);
+			branch->sizes[i] = children[i]->size;
+			branch->size += children[i]->size;
+			if constexpr (std::is_arithmetic<T>::value)
+			{
+				branch->sums[i] = SumOf(children[i]);
+				branch->sum += branch->sums[i];
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+		Builds the next version of the tree with a value inserted.
+
+	  \param old
+	  	The current root.
+
+	  \param v
+	  	The value to insert.
+
+	  \return
+	  	The new root.
+    ********************************************************************/
+	ChunkNode* BuildInsert(ChunkNode const* old, T const& v) const
+	{
+		ChunkNode* split = nullptr;
+		ChunkNode* fresh = CopyPath(old, v, split);
+		if(!split)
+			return fresh;
+
+		// The root itself split, so the tree grows by one level
+		Branch* top = new Branch();
+		ChunkNode* children[2] = { fresh, split };
+		Fill(top, children, 2);
+		return top;
+	}
+
+	/*!******************************************************************
+      \brief
+		Hand an old/replaced root to the reclaimer, which releases it
+		once no reader can still be using it.
+
+	  \param oldRoot
+	  	The root that has just been replaced.
+    ********************************************************************/
+	void Retire(ChunkNode* oldRoot)
+	{
+		reclaimer.Retire(oldRoot, [](void* pointer)
+		{
+			Release(static_cast<ChunkNode*>(pointer));
+		});
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ChunkedLFSV class.
+
+	  \param compare
+	  	The ordering to sort values by.
+    ********************************************************************/
+	ChunkedLFSV(Compare const& compare = Compare()) : comp(compare), reclaimer(), root(new Leaf())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the ChunkedLFSV class.
+    ********************************************************************/
+	~ChunkedLFSV()
+	{
+		Release(root.load());
+
+		// No other thread may be using the container at this point
+		reclaimer.Drain();
+	}
+
+	/*!******************************************************************
+      \brief
+        Insert a new value into the vector.
+
+      \param v
+        Reference to the new value to insert into the vector.
+    ********************************************************************/
+	void Insert(T const& v)
+	{
+		ChunkNode* root_new = nullptr; // Path-copied version of the tree
+		ChunkNode* root_old = nullptr; // Version the copy was built from
+		ChunkNode* last = nullptr;     // Used to check if insert needs to performed on new data
+
+		typename Reclaimer::Guard hp(reclaimer);
+
+		do {
+			root_old = hp.Protect(root);
+
+			// If the insertion needs to be performed again,
+			if(last != root_old)
+			{
+				// Discard the path copied from the previous version
+				if(root_new)
+					Release(root_new);
+
+				root_new = BuildInsert(root_old, v);
+				last = root_old;
+			}
+		} while (!root.compare_exchange_weak(root_old, root_new));
+
+		// Release the guard and retire the "old" root after it has been replaced
+		hp.Clear();
+		Retire(root_old);
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the value at a specific index within the vector.
+
+      \param pos
+        The index within the vector to pull a value from.
+
+      \return
+        The value at the specified position within the vector.
+    ********************************************************************/
+	T operator[](std::size_t pos)
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+
+		// Walk down by subtree sizes until the owning chunk is reached
+		T ret_val = At(hp.Protect(root), pos);
+
+		hp.Clear();
+
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the number of values within the vector.
+
+      \return
+        The number of values within the current version of the vector.
+    ********************************************************************/
+	std::size_t size()
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		std::size_t ret_val = hp.Protect(root)->size;
+		hp.Clear();
+		return ret_val;
+	}
+
+    /**************************************************************************/
+    /*!
+      \class Snapshot
+      \brief  
+        A read-only view of one version of the tree, pinned by the
+        reclaimer for as long as the handle lives. Every query walks one
+        root-to-chunk path using the sizes and sums cached in the
+        branches, so it costs O(log n) and no further hazard acquires.
+        A snapshot must be destroyed on the thread that created it.
+
+        Non-Core Operations Include:
+
+        -Return the number of values within the snapshot.
+        -Return the value at a specific index within the snapshot.
+        -Rank, select, count, sum or take a percentile of the values.
+
+    */
+    /**************************************************************************/
+	class Snapshot
+	{
+		typename Reclaimer::Pin pin; // Keeps the pinned root from being released
+		ChunkNode const* node;       // The pinned root
+		Compare comp;                // Ordering of the values
+
+		public:
+
+		/*!******************************************************************
+		  \brief
+			Constructor for the Snapshot class. Pins the current root of
+			a container's tree.
+
+		  \param reclaimer
+			The reclaimer of the container.
+
+		  \param source
+			The container's current root.
+
+		  \param compare
+			The ordering of the container's values.
+		********************************************************************/
+		Snapshot(Reclaimer& reclaimer, std::atomic<ChunkNode*> const& source, Compare const& compare)
+			: pin(reclaimer), node(pin.Protect(source)), comp(compare)
+		{}
+
+		/*!******************************************************************
+		  \brief
+			Move constructor for the Snapshot class.
+
+		  \param other
+			The snapshot to take the pin from.
+		********************************************************************/
+		Snapshot(Snapshot&& other) : pin(std::move(other.pin)), node(other.node), comp(other.comp)
+		{}
+
+		Snapshot(Snapshot const&) = delete;
+		Snapshot& operator=(Snapshot const&) = delete;
+		Snapshot& operator=(Snapshot&&) = delete;
+
+		/*!******************************************************************
+		  \brief
+			Return the number of values within the snapshot.
+
+		  \return
+			The number of values.
+		********************************************************************/
+		std::size_t size() const
+		{
+			return node->size;
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the value at a specific index within the snapshot.
+
+		  \param pos
+			The index within the snapshot to pull a value from.
+
+		  \return
+			The value at the specified position.
+		********************************************************************/
+		T const& operator[](std::size_t pos) const
+		{
+			return At(node, pos);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the # of values less than v.
+
+		  \param v
+			The value to rank.
+
+		  \return
+			The rank of v.
+		********************************************************************/
+		std::size_t Rank(T const& v) const
+		{
+			return CountBelow(node, v, comp, nullptr);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the k-th smallest value (counting from 0).
+
+		  \param k
+			The rank of the value to return.
+
+		  \return
+			The value.
+		********************************************************************/
+		T const& Select(std::size_t k) const
+		{
+			if(k >= node->size)
+				throw std::out_of_range("ChunkedLFSV: select rank out of range");
+			return At(node, k);
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the # of values within [lo, hi).
+
+		  \param lo
+			The lowest value to count.
+
+		  \param hi
+			The value to stop counting at.
+
+		  \return
+			The # of values within the range.
+		********************************************************************/
+		std::size_t CountRange(T const& lo, T const& hi) const
+		{
+			std::size_t low = Rank(lo);
+			std::size_t high = Rank(hi);
+			return high > low ? high - low : 0;
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the value at the p-th percentile, by nearest rank.
+
+		  \param p
+			The percentile, from 0 to 100.
+
+		  \return
+			The value.
+		********************************************************************/
+		T const& Percentile(double p) const
+		{
+			if(node->size == 0)
+				throw std::out_of_range("ChunkedLFSV: percentile of an empty snapshot");
+			return At(node, PercentileIndex(p, node->size));
+		}
+
+		/*!******************************************************************
+		  \brief
+			Return the sum of the values within [lo, hi), as the
+			difference of two prefix sums built from cached subtree sums.
+
+		  \param lo
+			The lowest value to add.
+
+		  \param hi
+			The value to stop adding at.
+
+		  \return
+			The sum, in ValueSum<T>::type.
+		********************************************************************/
+		Sum SumRange(T const& lo, T const& hi) const
+		{
+			static_assert(std::is_arithmetic<T>::value, "ChunkedLFSV: SumRange needs arithmetic values");
+
+			if(!comp(lo, hi))
+				return 0;
+
+			Sum low = 0;
+			Sum high = 0;
+			CountBelow(node, lo, comp, &low);
+			CountBelow(node, hi, comp, &high);
+			return high - low;
+		}
+	};
+
+	/*!******************************************************************
+      \brief
+        Pin the current version of the tree for reading.
+
+      \return
+        A snapshot handle holding the pin.
+    ********************************************************************/
+	Snapshot GetSnapshot()
+	{
+		return Snapshot(reclaimer, root, comp);
+	}
+};
@@ -0,0 +1,622 @@
+/******************************************************************************/
+/*!
+\file   lfsv_driver.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the benchmark driver for the LFSV class. It runs a
+	configurable mix of reads and inserts from a sweep of thread counts
+	and prints one machine-readable line per run, so runs can be compared
+	across commits.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_driver.cpp -o lfsv_driver
+	Usage:      lfsv_driver [key=value ...]
+
+	Keys (defaults in brackets):
+	  threads=1,2,4,8   Thread counts to sweep; each thread mixes reads and inserts
+	  readers=0         Extra threads that only read
+	  writers=0         Extra threads that only insert
+	  reads=50          Percentage of a mixed thread's operations that are reads
+	  ops=100000        Operations per run, split evenly between all threads
+	  initial=10000     # of values inserted before the timed run starts
+	  dist=uniform      Insert keys: uniform, sorted, reverse or zipf
+	  range=1000000     Keys are drawn from [0, range)
+	  reclaimer=hazard  hazard, shared or epoch
+	  mode=cas          cas, combining or staged
+	  format=json       json (one object per line) or csv
+	  trace=            File prefix; writes <prefix>.json and <prefix>.hgrm
+	                    (only accepted by a -DLFSV_TRACING build)
+
+	Reads pick an index below the initial size, which is always valid as
+	the run only inserts. Memory is measured per run: on Linux the peak
+	resident set is reset (through /proc/self/clear_refs) just before each
+	run's container is built, and rss_delta_kb is how far the peak rose
+	above the resident set at that point. Where the peak cannot be reset,
+	rss_reset is 0 and peak_rss_kb is the process's peak so far, which
+	never decreases from one run to the next. Build with -DLFSV_STATS to
+	add the container's contention and reclamation counters to each line,
+	in either format. Build with -DLFSV_TRACING and pass trace= to dump
+	the last events of every thread, after the sweep, as a Chrome trace
+	and as per-operation latency histograms.
+
+*/
+/******************************************************************************/
+
+#include "lfsv.h"
+#include <chrono>  // std::chrono
+#include <cmath>   // std::pow
+#include <cstdlib> // std::atoi
+#include <random>  // std::mt19937
+#include <string>  // std::string
+#include <sstream> // std::stringstream
+#include <fstream> // std::ofstream, std::ifstream
+#include <utility> // std::pair
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // getrusage
+#endif
+
+/*!
+  \struct Config
+  \brief
+    Settings for a sweep of benchmark runs, parsed from the command line.
+*/
+struct Config
+{
+	std::vector<int> threads{1, 2, 4, 8}; // Mixed thread counts to sweep
+	int readers = 0;                      // Extra read-only threads
+	int writers = 0;                      // Extra insert-only threads
+	int reads = 50;                       // Percentage of mixed operations that are reads
+	int ops = 100000;                     // Operations per run
+	int initial = 10000;                  // Values inserted before each run
+	std::string dist = "uniform";         // Key distribution for inserts
+	int range = 1000000;                  // Keys are drawn from [0, range)
+	std::string reclaimer = "hazard";     // Reclamation policy
+	std::string mode = "cas";             // Write mode
+	std::string format = "json";          // Output format
+	std::string trace;                    // Prefix of the trace files; none if empty
+};
+
+/*!
+  \struct Result
+  \brief
+    The measurements taken by a single benchmark run.
+*/
+struct Result
+{
+	int threads = 0;                 // # of threads that took part
+	double seconds = 0.0;            // Wall time of the timed section
+	long long reads = 0;             // # of reads performed
+	long long inserts = 0;           // # of inserts performed
+	std::uint32_t readP[3] = {0, 0, 0};   // p50/p99/p999 read latency, in ns
+	std::uint32_t insertP[3] = {0, 0, 0}; // p50/p99/p999 insert latency, in ns
+	std::size_t peakUnreclaimed = 0; // Highest # of retired versions seen
+	long peakRssKb = 0;              // Peak resident set during the run, in KiB
+	long rssDeltaKb = 0;             // How far the peak rose during the run, in KiB
+	bool rssReset = false;           // Whether the peak was reset for this run
+	LFSVStats stats;                 // The container's counters, if compiled in
+};
+
+/**************************************************************************/
+/*!
+  \class KeySource
+  \brief
+    Produces insert keys for one thread according to a distribution.
+	Sorted and reverse keys come from a counter shared by every thread, so
+	the container as a whole sees an ascending or descending stream.
+
+    Non-Core Operations Include:
+
+    -Return the next key to insert.
+
+*/
+/**************************************************************************/
+class KeySource
+{
+	std::string const& dist;            // Name of the distribution
+	int range;                          // Keys are drawn from [0, range)
+	std::atomic<long long>& counter;    // Shared counter for sorted and reverse keys
+	std::vector<double> const& zipfCdf; // Cumulative Zipf weights, one per key
+	std::mt19937 rng;                   // This thread's random source
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the KeySource class.
+
+	  \param name
+	  	Name of the distribution.
+
+	  \param keys
+	  	Keys are drawn from [0, keys).
+
+	  \param shared
+	  	Counter shared by every thread, for sorted and reverse keys.
+
+	  \param cdf
+	  	Cumulative Zipf weights, used when the distribution is zipf.
+
+	  \param seed
+	  	Seed for this thread's random source.
+    ********************************************************************/
+	KeySource(std::string const& name, int keys, std::atomic<long long>& shared,
+	          std::vector<double> const& cdf, unsigned seed)
+		: dist(name), range(keys), counter(shared), zipfCdf(cdf), rng(seed)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Return the next key to insert.
+
+	  \return
+	  	The key.
+    ********************************************************************/
+	int Next()
+	{
+		if(dist == "sorted")
+			return static_cast<int>(counter.fetch_add(1, std::memory_order_relaxed) % range);
+		if(dist == "reverse")
+			return range - 1 - static_cast<int>(counter.fetch_add(1, std::memory_order_relaxed) % range);
+		if(dist == "zipf")
+		{
+			double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+			return static_cast<int>(std::lower_bound(zipfCdf.begin(), zipfCdf.end(), u) - zipfCdf.begin());
+		}
+		return static_cast<int>(rng() % range);
+	}
+};
+
+/*!******************************************************************
+  \brief
+    Builds the cumulative weights of a Zipf distribution (s = 0.99)
+	over [0, range), with key 0 the most popular.
+
+  \param range
+	The # of keys.
+
+  \return
+	The cumulative weights, normalized to end at 1.
+********************************************************************/
+std::vector<double> BuildZipf(int range)
+{
+	std::vector<double> cdf(range);
+	double total = 0.0;
+	for(int i = 0; i < range; ++i)
+	{
+		total += 1.0 / std::pow(i + 1.0, 0.99);
+		cdf[i] = total;
+	}
+	for(double& weight : cdf)
+		weight /= total;
+	return cdf;
+}
+
+/*!******************************************************************
+  \brief
+    Fills in the p50, p99 and p999 of a set of latencies.
+
+  \param samples
+	The latencies, in ns. Sorted in place.
+
+  \param out
+	The three percentiles, in ns.
+********************************************************************/
+void Percentiles(std::vector<std::uint32_t>& samples, std::uint32_t* out)
+{
+	if(samples.empty())
+		return;
+
+	std::sort(samples.begin(), samples.end());
+	double const points[3] = {0.50, 0.99, 0.999};
+	for(int i = 0; i < 3; ++i)
+		out[i] = samples[static_cast<std::size_t>(points[i] * (samples.size() - 1))];
+}
+
+/*!******************************************************************
+  \brief
+    Reads one "Name:  value kB" line of /proc/self/status.
+
+  \param name
+	The field to read, such as "VmHWM".
+
+  \return
+	The value in KiB, or -1 where it cannot be read.
+********************************************************************/
+long ProcStatusKb(std::string const& name)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while(std::getline(status, line))
+		if(line.compare(0, name.size() + 1, name + ":") == 0)
+			return std::atol(line.c_str() + name.size() + 1);
+	return -1;
+}
+
+/*!******************************************************************
+  \brief
+    Resets the process's peak resident set to its current one, so the
+	next PeakRssKb() only covers what happens from here on.
+
+  \return
+	Whether the peak could be reset (Linux 4.0 and later).
+********************************************************************/
+bool ResetPeakRss()
+{
+	std::ofstream clear("/proc/self/clear_refs");
+	clear << "5" << std::flush;
+	return static_cast<bool>(clear) && ProcStatusKb("VmHWM") >= 0;
+}
+
+/*!******************************************************************
+  \brief
+    Returns the current resident set of the process.
+
+  \return
+	The resident set in KiB, or 0 where it cannot be measured.
+********************************************************************/
+long RssKb()
+{
+	return std::max(ProcStatusKb("VmRSS"), 0L);
+}
+
+/*!******************************************************************
+  \brief
+    Returns the peak resident set of the process since the last
+	ResetPeakRss(), or since it started if that is not supported.
+
+  \return
+	The peak resident set in KiB, or 0 where it cannot be measured.
+********************************************************************/
+long PeakRssKb()
+{
+	long hwm = ProcStatusKb("VmHWM");
+	if(hwm >= 0)
+		return hwm;
+#if defined(__APPLE__)
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024; // Reported in bytes
+#elif defined(__unix__)
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss; // Reported in KiB
+#else
+	return 0;
+#endif
+}
+
+/*!******************************************************************
+  \brief
+    Returns the container counters reported with each run, by name, so
+	the JSON and CSV formats always carry the same fields.
+
+  \param stats
+	The counters.
+
+  \return
+	The fields to report; empty unless the counters were compiled in.
+********************************************************************/
+std::vector<std::pair<char const*, std::uint64_t>> StatFields(LFSVStats const& stats)
+{
+	if(!stats.enabled)
+		return {};
+
+	return {
+		{"cas_failures", stats.casFailures}, {"discarded", stats.discarded},
+		{"retired", stats.reclaim.retired}, {"reclaimed", stats.reclaim.reclaimed},
+		{"scans", stats.reclaim.scans}, {"scan_ns", stats.reclaim.scanNanos},
+		{"max_retired", stats.reclaim.maxRetired},
+		{"bank_capacity", stats.bank.capacity}, {"bank_in_use", stats.bank.inUse},
+		{"bank_shared_ns", stats.bank.sharedNanos}
+	};
+}
+
+/*!******************************************************************
+  \brief
+    Runs one timed mix of reads and inserts against a freshly filled
+	container.
+
+  \param config
+	The settings for the run.
+
+  \param mixed
+	# of threads mixing reads and inserts.
+
+  \param zipfCdf
+	Cumulative Zipf weights, used when the distribution is zipf.
+
+  \return
+	The measurements taken.
+********************************************************************/
+template <typename Container>
+Result Run(Config const& config, int mixed, std::vector<double> const& zipfCdf)
+{
+	Result result;
+	result.rssReset = ResetPeakRss();
+	long baseRssKb = RssKb();
+
+	Container container(config.mode == "combining" ? WriteMode::Combining
+	                  : config.mode == "staged"    ? WriteMode::Staged : WriteMode::CAS);
+
+	// Fill outside of the timed section
+	{
+		std::mt19937 rng(12345);
+		std::vector<int> fill(config.initial > 0 ? config.initial : 1);
+		for(int& value : fill)
+			value = static_cast<int>(rng() % config.range);
+		container.InsertBatch(fill.data(), fill.size());
+	}
+	int readable = config.initial > 0 ? config.initial : 1; // Indices always in range
+
+	int total = mixed + config.readers + config.writers;
+	int perThread = config.ops / total;
+
+	std::atomic<long long> counter(0);
+	std::atomic<long long> sink(0);
+	std::atomic<int> running(total);
+	std::vector<std::vector<std::uint32_t>> readSamples(total);
+	std::vector<std::vector<std::uint32_t>> insertSamples(total);
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int t = 0; t < total; ++t)
+	{
+		int readPercent = t < mixed ? config.reads : (t < mixed + config.readers ? 100 : 0);
+		workers.emplace_back([&, t, readPercent]()
+		{
+			KeySource keys(config.dist, config.range, counter, zipfCdf, t + 1);
+			std::mt19937 rng(t + 1001);
+			std::vector<std::uint32_t>& reads = readSamples[t];
+			std::vector<std::uint32_t>& inserts = insertSamples[t];
+			reads.reserve(perThread * readPercent / 100 + 1);
+			inserts.reserve(perThread - perThread * readPercent / 100 + 1);
+			long long sum = 0;
+
+			for(int i = 0; i < perThread; ++i)
+			{
+				bool read = static_cast<int>(rng() % 100) < readPercent;
+				int key = read ? 0 : keys.Next();
+				std::size_t index = rng() % readable;
+
+				auto begin = std::chrono::steady_clock::now();
+				if(read)
+					sum += container[index];
+				else
+					container.Insert(key);
+				auto end = std::chrono::steady_clock::now();
+
+				std::uint32_t nanos = static_cast<std::uint32_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+				(read ? reads : inserts).push_back(nanos);
+			}
+
+			sink.fetch_add(sum, std::memory_order_relaxed); // Keeps the reads from being optimized away
+			running.fetch_sub(1);
+		});
+	}
+
+	// Sample the retired backlog while the workers run
+	while(running.load() > 0)
+	{
+		result.peakUnreclaimed = std::max(result.peakUnreclaimed, container.Unreclaimed());
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+	auto end = std::chrono::steady_clock::now();
+	for(std::thread& worker : workers)
+		worker.join();
+
+	std::vector<std::uint32_t> reads;
+	std::vector<std::uint32_t> inserts;
+	for(int t = 0; t < total; ++t)
+	{
+		reads.insert(reads.end(), readSamples[t].begin(), readSamples[t].end());
+		inserts.insert(inserts.end(), insertSamples[t].begin(), insertSamples[t].end());
+	}
+
+	result.threads = total;
+	result.seconds = std::chrono::duration<double>(end - start).count();
+	result.reads = static_cast<long long>(reads.size());
+	result.inserts = static_cast<long long>(inserts.size());
+	Percentiles(reads, result.readP);
+	Percentiles(inserts, result.insertP);
+	result.peakRssKb = PeakRssKb();
+	result.rssDeltaKb = std::max(result.peakRssKb - baseRssKb, 0L);
+	result.stats = container.Stats();
+	return result;
+}
+
+/*!******************************************************************
+  \brief
+    Prints one run as a single line of JSON or CSV. The CSV header is
+	printed along with the first run, once it is known whether the
+	counters were compiled in.
+
+  \param config
+	The settings the run used.
+
+  \param mixed
+	# of threads that mixed reads and inserts.
+
+  \param result
+	The measurements taken.
+********************************************************************/
+void Report(Config const& config, int mixed, Result const& result)
+{
+	long long opsPerSec = static_cast<long long>((result.reads + result.inserts) / result.seconds);
+
+	std::vector<std::pair<char const*, std::uint64_t>> stats = StatFields(result.stats);
+
+	if(config.format == "csv")
+	{
+		static bool header = false;
+		if(!header)
+		{
+			std::cout << "reclaimer,mode,dist,initial,reads_pct,mixed,readers,writers,threads,reads,inserts,"
+			             "seconds,ops_per_sec,read_p50_ns,read_p99_ns,read_p999_ns,insert_p50_ns,"
+			             "insert_p99_ns,insert_p999_ns,peak_unreclaimed,peak_rss_kb,rss_delta_kb,rss_reset";
+			for(auto const& field : stats)
+				std::cout << ',' << field.first;
+			std::cout << std::endl;
+			header = true;
+		}
+
+		std::cout << config.reclaimer << ',' << config.mode << ',' << config.dist << ','
+		          << config.initial << ',' << config.reads << ',' << mixed << ','
+		          << config.readers << ',' << config.writers << ',' << result.threads << ','
+		          << result.reads << ',' << result.inserts << ',' << result.seconds << ','
+		          << opsPerSec << ',' << result.readP[0] << ',' << result.readP[1] << ','
+		          << result.readP[2] << ',' << result.insertP[0] << ',' << result.insertP[1] << ','
+		          << result.insertP[2] << ',' << result.peakUnreclaimed << ','
+		          << result.peakRssKb << ',' << result.rssDeltaKb << ',' << result.rssReset;
+		for(auto const& field : stats)
+			std::cout << ',' << field.second;
+		std::cout << std::endl;
+		return;
+	}
+
+	std::cout << "{\"reclaimer\":\"" << config.reclaimer << "\",\"mode\":\"" << config.mode
+	          << "\",\"dist\":\"" << config.dist << "\",\"initial\":" << config.initial
+	          << ",\"reads_pct\":" << config.reads << ",\"mixed\":" << mixed
+	          << ",\"readers\":" << config.readers << ",\"writers\":" << config.writers
+	          << ",\"threads\":" << result.threads << ",\"reads\":" << result.reads
+	          << ",\"inserts\":" << result.inserts << ",\"seconds\":" << result.seconds
+	          << ",\"ops_per_sec\":" << opsPerSec
+	          << ",\"read_p50_ns\":" << result.readP[0] << ",\"read_p99_ns\":" << result.readP[1]
+	          << ",\"read_p999_ns\":" << result.readP[2]
+	          << ",\"insert_p50_ns\":" << result.insertP[0] << ",\"insert_p99_ns\":" << result.insertP[1]
+	          << ",\"insert_p999_ns\":" << result.insertP[2]
+	          << ",\"peak_unreclaimed\":" << result.peakUnreclaimed
+	          << ",\"peak_rss_kb\":" << result.peakRssKb << ",\"rss_delta_kb\":" << result.rssDeltaKb
+	          << ",\"rss_reset\":" << result.rssReset;
+
+	for(auto const& field : stats)
+		std::cout << ",\"" << field.first << "\":" << field.second;
+	std::cout << "}" << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Parses key=value arguments into a configuration.
+
+  \param argc
+	# of command line arguments.
+
+  \param argv
+	Command line arguments.
+
+  \param config
+	The configuration to fill in.
+
+  \return
+	Whether every argument was understood.
+********************************************************************/
+bool Parse(int argc, char* argv[], Config& config)
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		std::size_t eq = arg.find('=');
+		if(eq == std::string::npos)
+			return false;
+
+		std::string key = arg.substr(0, eq);
+		std::string value = arg.substr(eq + 1);
+
+		if(key == "threads")
+		{
+			config.threads.clear();
+			std::stringstream list(value);
+			std::string count;
+			while(std::getline(list, count, ','))
+				config.threads.push_back(std::atoi(count.c_str()));
+		}
+		else if(key == "readers")   config.readers = std::atoi(value.c_str());
+		else if(key == "writers")   config.writers = std::atoi(value.c_str());
+		else if(key == "reads")     config.reads = std::atoi(value.c_str());
+		else if(key == "ops")       config.ops = std::atoi(value.c_str());
+		else if(key == "initial")   config.initial = std::atoi(value.c_str());
+		else if(key == "dist")      config.dist = value;
+		else if(key == "range")     config.range = std::atoi(value.c_str());
+		else if(key == "reclaimer") config.reclaimer = value;
+		else if(key == "mode")      config.mode = value;
+		else if(key == "format")    config.format = value;
+		else if(key == "trace")
+		{
+#ifdef LFSV_TRACING
+			config.trace = value;
+#else
+			std::cerr << "lfsv_driver: trace= needs a build with -DLFSV_TRACING" << std::endl;
+			return false;
+#endif
+		}
+		else
+			return false;
+	}
+
+	return config.range > 0 && config.ops > 0 && config.reads >= 0 && config.reads <= 100 &&
+	       (config.dist == "uniform" || config.dist == "sorted" ||
+	        config.dist == "reverse" || config.dist == "zipf") &&
+	       (config.reclaimer == "hazard" || config.reclaimer == "shared" || config.reclaimer == "epoch") &&
+	       (config.mode == "cas" || config.mode == "combining" || config.mode == "staged") &&
+	       (config.format == "json" || config.format == "csv");
+}
+
+/*!******************************************************************
+  \brief
+    Entry point for the benchmark driver.
+
+  \param argc
+	# of command line arguments.
+
+  \param argv
+	Command line arguments: key=value pairs, see the file header.
+
+  \return
+	0 on success, 1 on a bad argument.
+********************************************************************/
+int main(int argc, char* argv[])
+{
+	Config config;
+	if(!Parse(argc, argv, config))
+	{
+		std::cerr << "usage: lfsv_driver [threads=1,2,4,8] [readers=N] [writers=N] [reads=PCT] "
+		             "[ops=N] [initial=N] [dist=uniform|sorted|reverse|zipf] [range=N] "
+		             "[reclaimer=hazard|shared|epoch] [mode=cas|combining|staged] [format=json|csv] "
+		             "[trace=PREFIX]" << std::endl;
+		return 1;
+	}
+
+	std::vector<double> zipfCdf;
+	if(config.dist == "zipf")
+		zipfCdf = BuildZipf(config.range);
+
+	for(int mixed : config.threads)
+	{
+		if(mixed + config.readers + config.writers <= 0)
+			continue;
+
+		Result result = config.reclaimer == "epoch"
+			? Run<LFSV<int, std::less<int>, std::allocator<int>, EpochReclaimer>>(config, mixed, zipfCdf)
+			: config.reclaimer == "shared"
+			? Run<LFSV<int, std::less<int>, std::allocator<int>, SharedHazardReclaimer>>(config, mixed, zipfCdf)
+			: Run<LFSV<>>(config, mixed, zipfCdf);
+		Report(config, mixed, result);
+	}
+
+	if(!config.trace.empty())
+	{
+		std::ofstream chrome(config.trace + ".json");
+		Tracer::Global().WriteChromeTrace(chrome);
+		std::ofstream histograms(config.trace + ".hgrm");
+		Tracer::Global().WriteHistograms(histograms);
+	}
+
+	return 0;
+}
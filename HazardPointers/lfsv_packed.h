@@ -0,0 +1,866 @@
+/******************************************************************************/
+/*!
+\file   lfsv_packed.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the definition of the PackedLFSV class template, a
+	variant of LFSV for ints that stores its values compressed. Values are
+	split into fixed-size blocks, each holding a base value and either
+	bit-packed deltas or bit-packed runs of duplicates. A version of the
+	container is just a list of blocks plus a skip index over them, so an
+	insert re-encodes one block and copies a few bytes per block rather
+	than every value.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include "lfsv.h"
+
+const unsigned packedBlock = 128; // Max # of values held by one block
+
+/**************************************************************************/
+/*!
+  \struct PackedBlock
+  \brief
+    An immutable, compressed run of up to packedBlock sorted ints. The
+	payload is a stream of 64-bit words laid out right after the header,
+	holding either count - 1 deltas of width bits each, or runs of equal
+	values: runs - 1 deltas of width bits followed by runs lengths of
+	lengthWidth bits. Whichever of the two is smaller is kept.
+
+	Blocks are shared by every version of the container that lists them,
+	and are only freed along with the version that stopped listing them.
+
+*/
+/**************************************************************************/
+struct alignas(8) PackedBlock
+{
+	int low;                  // First (lowest) value of the block
+	int high;                 // Last (highest) value of the block
+	std::uint16_t count;      // # of values
+	std::uint16_t runs;       // # of runs of equal values, or 0 if delta encoded
+	std::uint8_t width;       // Bits per delta
+	std::uint8_t lengthWidth; // Bits per run length (minus one), if run encoded
+	std::uint32_t words;      // # of payload words, plus one word of padding
+
+	/*!******************************************************************
+      \brief
+        Returns the payload words that follow the header.
+
+	  \return
+	  	The first payload word.
+    ********************************************************************/
+	std::uint64_t* Words()
+	{
+		return reinterpret_cast<std::uint64_t*>(this + 1);
+	}
+
+	std::uint64_t const* Words() const
+	{
+		return reinterpret_cast<std::uint64_t const*>(this + 1);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of bytes the block takes up, header included.
+
+	  \return
+	  	The # of bytes.
+    ********************************************************************/
+	std::size_t Bytes() const
+	{
+		return sizeof(PackedBlock) + words * sizeof(std::uint64_t);
+	}
+};
+
+/*!******************************************************************
+  \brief
+    Returns the # of bits needed to hold a value.
+
+  \param value
+	The value.
+
+  \return
+	The bit width, or 0 if the value is 0.
+********************************************************************/
+inline unsigned BitWidth(std::uint32_t value)
+{
+	unsigned width = 0;
+	for(; value != 0; value >>= 1)
+		++width;
+	return width;
+}
+
+/*!******************************************************************
+  \brief
+    Writes a value into a stream of zeroed 64-bit words.
+
+  \param words
+	The stream.
+
+  \param offset
+	The bit offset to write at.
+
+  \param value
+	The value; must fit within width bits.
+
+  \param width
+	The # of bits to write.
+********************************************************************/
+inline void PackBits(std::uint64_t* words, std::size_t offset, std::uint32_t value, unsigned width)
+{
+	if(width == 0)
+		return;
+
+	std::size_t word = offset / 64;
+	unsigned shift = static_cast<unsigned>(offset % 64);
+	words[word] |= static_cast<std::uint64_t>(value) << shift;
+	if(shift + width > 64)
+		words[word + 1] |= static_cast<std::uint64_t>(value) >> (64 - shift);
+}
+
+/*!******************************************************************
+  \brief
+    Reads a value out of a stream of 64-bit words. The stream must be
+	padded with one extra word.
+
+  \param words
+	The stream.
+
+  \param offset
+	The bit offset to read at.
+
+  \param width
+	The # of bits to read, at most 32.
+
+  \return
+	The value.
+********************************************************************/
+inline std::uint32_t UnpackBits(std::uint64_t const* words, std::size_t offset, unsigned width)
+{
+	if(width == 0)
+		return 0;
+
+	std::size_t word = offset / 64;
+	unsigned shift = static_cast<unsigned>(offset % 64);
+	std::uint64_t bits = words[word] >> shift;
+	if(shift != 0)
+		bits |= words[word + 1] << (64 - shift);
+	return static_cast<std::uint32_t>(bits & ((std::uint64_t(1) << width) - 1));
+}
+
+/*!******************************************************************
+  \brief
+    Turns a run of deltas into the values they lead to, in place.
+
+  \param values
+	The deltas on entry, the values on return.
+
+  \param n
+	The # of deltas.
+
+  \param base
+	The value the first delta is added to.
+********************************************************************/
+inline void PrefixSumScalar(std::uint32_t* values, std::size_t n, std::uint32_t base)
+{
+	for(std::size_t i = 0; i < n; ++i)
+		values[i] = base += values[i];
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/*!******************************************************************
+  \brief
+    AVX2 version of PrefixSumScalar(): scans eight deltas at a time with
+	two in-lane shifts and one cross-lane carry. Only called once the
+	CPU has been checked for AVX2 support.
+
+  \param values
+	The deltas on entry, the values on return.
+
+  \param n
+	The # of deltas.
+
+  \param base
+	The value the first delta is added to.
+********************************************************************/
+__attribute__((target("avx2")))
+inline void PrefixSumAvx2(std::uint32_t* values, std::size_t n, std::uint32_t base)
+{
+	__m256i carry = _mm256_set1_epi32(static_cast<int>(base));
+	__m256i last = _mm256_set1_epi32(7);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+	{
+		__m256i run = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values + i));
+		run = _mm256_add_epi32(run, _mm256_slli_si256(run, 4));
+		run = _mm256_add_epi32(run, _mm256_slli_si256(run, 8));
+		__m256i low = _mm256_shuffle_epi32(run, _MM_SHUFFLE(3, 3, 3, 3));
+		run = _mm256_add_epi32(run, _mm256_permute2x128_si256(low, low, 0x08));
+		run = _mm256_add_epi32(run, carry);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), run);
+		carry = _mm256_permutevar8x32_epi32(run, last);
+	}
+	PrefixSumScalar(values + i, n - i, static_cast<std::uint32_t>(_mm256_cvtsi256_si32(carry)));
+}
+#endif
+
+/*!******************************************************************
+  \brief
+    Picks the fastest PrefixSum kernel the running CPU supports.
+	Detection only happens once per process.
+
+  \return
+	The kernel to use.
+********************************************************************/
+inline void (*PrefixSumKernel())(std::uint32_t*, std::size_t, std::uint32_t)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	static void (*const kernel)(std::uint32_t*, std::size_t, std::uint32_t) =
+		__builtin_cpu_supports("avx2") ? &PrefixSumAvx2 : &PrefixSumScalar;
+	return kernel;
+#else
+	return &PrefixSumScalar;
+#endif
+}
+
+/*!******************************************************************
+  \brief
+    Encodes a sorted run of ints into a new block, picking whichever of
+	delta or run encoding is smaller.
+
+  \param values
+	The values.
+
+  \param n
+	The # of values, from 1 to packedBlock.
+
+  \return
+	The new block; free it with DestroyBlock().
+********************************************************************/
+inline PackedBlock* EncodeBlock(int const* values, unsigned n)
+{
+	// Measure both encodings in one pass
+	std::uint32_t maxDelta = 0;
+	std::uint32_t maxRunDelta = 0;
+	unsigned maxLength = 0;
+	unsigned runs = 1;
+	unsigned length = 1;
+	for(unsigned i = 1; i < n; ++i)
+	{
+		std::uint32_t delta = static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(values[i - 1]);
+		maxDelta = std::max(maxDelta, delta);
+		if(delta == 0)
+			++length;
+		else
+		{
+			maxRunDelta = std::max(maxRunDelta, delta);
+			maxLength = std::max(maxLength, length - 1);
+			++runs;
+			length = 1;
+		}
+	}
+	maxLength = std::max(maxLength, length - 1);
+
+	unsigned width = BitWidth(maxDelta);
+	unsigned runWidth = BitWidth(maxRunDelta);
+	unsigned lengthWidth = BitWidth(maxLength);
+	std::size_t deltaBits = static_cast<std::size_t>(n - 1) * width;
+	std::size_t runBits = static_cast<std::size_t>(runs - 1) * runWidth + static_cast<std::size_t>(runs) * lengthWidth;
+	bool useRuns = runBits < deltaBits;
+	std::size_t words = ((useRuns ? runBits : deltaBits) + 63) / 64 + 1;
+
+	void* memory = ::operator new(sizeof(PackedBlock) + words * sizeof(std::uint64_t));
+	PackedBlock* block = new (memory) PackedBlock();
+	block->low = values[0];
+	block->high = values[n - 1];
+	block->count = static_cast<std::uint16_t>(n);
+	block->words = static_cast<std::uint32_t>(words);
+	std::uint64_t* payload = block->Words();
+	std::fill(payload, payload + words, std::uint64_t(0));
+
+	if(!useRuns)
+	{
+		block->runs = 0;
+		block->width = static_cast<std::uint8_t>(width);
+		block->lengthWidth = 0;
+		for(unsigned i = 1; i < n; ++i)
+			PackBits(payload, static_cast<std::size_t>(i - 1) * width,
+			         static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(values[i - 1]), width);
+		return block;
+	}
+
+	block->runs = static_cast<std::uint16_t>(runs);
+	block->width = static_cast<std::uint8_t>(runWidth);
+	block->lengthWidth = static_cast<std::uint8_t>(lengthWidth);
+	std::size_t deltaOffset = 0;
+	std::size_t lengthOffset = static_cast<std::size_t>(runs - 1) * runWidth;
+	unsigned start = 0;
+	for(unsigned i = 1; i <= n; ++i)
+	{
+		if(i < n && values[i] == values[i - 1])
+			continue;
+
+		PackBits(payload, lengthOffset, i - start - 1, lengthWidth);
+		lengthOffset += lengthWidth;
+		if(i < n)
+		{
+			PackBits(payload, deltaOffset,
+			         static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(values[i - 1]), runWidth);
+			deltaOffset += runWidth;
+		}
+		start = i;
+	}
+	return block;
+}
+
+/*!******************************************************************
+  \brief
+    Frees a block made by EncodeBlock().
+
+  \param block
+	The block to free.
+********************************************************************/
+inline void DestroyBlock(PackedBlock* block)
+{
+	block->~PackedBlock();
+	::operator delete(block);
+}
+
+/*!******************************************************************
+  \brief
+    Decodes every value of a block. Delta encoded blocks unpack their
+	deltas and then rebuild the values with a SIMD prefix sum where the
+	CPU supports it.
+
+  \param block
+	The block to decode.
+
+  \param out
+	Room for block->count values.
+********************************************************************/
+inline void DecodeBlock(PackedBlock const* block, int* out)
+{
+	std::uint64_t const* payload = block->Words();
+	out[0] = block->low;
+
+	if(block->runs == 0)
+	{
+		std::uint32_t* deltas = reinterpret_cast<std::uint32_t*>(out + 1);
+		unsigned width = block->width;
+		for(unsigned i = 0; i + 1 < block->count; ++i)
+			deltas[i] = UnpackBits(payload, static_cast<std::size_t>(i) * width, width);
+		PrefixSumKernel()(deltas, block->count - 1u, static_cast<std::uint32_t>(block->low));
+		return;
+	}
+
+	std::size_t deltaOffset = 0;
+	std::size_t lengthOffset = static_cast<std::size_t>(block->runs - 1) * block->width;
+	std::uint32_t value = static_cast<std::uint32_t>(block->low);
+	int* next = out;
+	for(unsigned r = 0; r < block->runs; ++r)
+	{
+		if(r != 0)
+		{
+			value += UnpackBits(payload, deltaOffset, block->width);
+			deltaOffset += block->width;
+		}
+		unsigned length = UnpackBits(payload, lengthOffset, block->lengthWidth) + 1;
+		lengthOffset += block->lengthWidth;
+		next = std::fill_n(next, length, static_cast<int>(value));
+	}
+}
+
+/*!******************************************************************
+  \brief
+    Decodes a single value of a block, stopping as soon as it is known.
+
+  \param block
+	The block to read from.
+
+  \param index
+	The index of the value within the block.
+
+  \return
+	The value.
+********************************************************************/
+inline int BlockAt(PackedBlock const* block, unsigned index)
+{
+	std::uint64_t const* payload = block->Words();
+	std::uint32_t value = static_cast<std::uint32_t>(block->low);
+
+	if(block->runs == 0)
+	{
+		for(unsigned i = 0; i < index; ++i)
+			value += UnpackBits(payload, static_cast<std::size_t>(i) * block->width, block->width);
+		return static_cast<int>(value);
+	}
+
+	std::size_t deltaOffset = 0;
+	std::size_t lengthOffset = static_cast<std::size_t>(block->runs - 1) * block->width;
+	for(unsigned r = 0; ; ++r)
+	{
+		if(r != 0)
+		{
+			value += UnpackBits(payload, deltaOffset, block->width);
+			deltaOffset += block->width;
+		}
+		unsigned length = UnpackBits(payload, lengthOffset, block->lengthWidth) + 1;
+		lengthOffset += block->lengthWidth;
+		if(index < length)
+			return static_cast<int>(value);
+		index -= length;
+	}
+}
+
+/**************************************************************************/
+/*!
+  \struct PackedVersion
+  \brief
+    One version of a PackedLFSV: the blocks it lists and a skip index over
+	them. Copying a version copies the index, never the values. The
+	blocks its successor stopped listing are handed to it once it has
+	been replaced, and die along with it.
+
+	Older versions may still list those blocks, so versions are freed
+	strictly oldest first: each one holds a reference to its successor,
+	on top of the one the reclaimer drops once no reader can see it.
+
+*/
+/**************************************************************************/
+struct PackedVersion
+{
+	std::vector<PackedBlock*> blocks;  // The blocks, in value order
+	std::vector<int> lows;             // Lowest value of each block, for routing by value
+	std::vector<std::size_t> starts;   // # of values before each block, plus the total
+	std::vector<PackedBlock*> dropped; // Blocks the successor stopped listing; freed with this one
+	PackedVersion* successor;          // The version that replaced this one, if any
+	std::atomic<int> refs;             // Held by the reclaimer and by the predecessor
+
+	/*!******************************************************************
+      \brief
+        Constructor for the PackedVersion struct. Starts out empty.
+
+	  \param references
+	  	1 for a first version, 2 for one that replaces a predecessor.
+    ********************************************************************/
+	explicit PackedVersion(int references = 1)
+		: blocks(), lows(), starts(1, 0), dropped(), successor(nullptr), refs(references)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Drops a reference to a version, freeing it and then releasing
+		its successor once nothing refers to it anymore.
+
+	  \param version
+	  	The version to release.
+    ********************************************************************/
+	static void Release(PackedVersion* version)
+	{
+		while(version && version->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			PackedVersion* next = version->successor;
+			delete version;
+			version = next;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the PackedVersion struct. Frees the dropped blocks
+		only; listed blocks may still be listed by newer versions.
+    ********************************************************************/
+	~PackedVersion()
+	{
+		for(PackedBlock* block : dropped)
+			DestroyBlock(block);
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class PackedLFSV
+  \brief
+    A lock-free implementation of an automatically-sorting vector of ints,
+	stored as compressed blocks. Sorts elements from least to greatest.
+	Replaced versions are handed to Reclaimer, which decides when they are
+	safe to release.
+
+	An insert or erase decodes the one block it lands in, re-encodes it
+	(splitting it if it overflows, or dropping it once empty), and
+	publishes a new skip index that shares every other block. Clustered
+	values pack into a few bits each, so both the memory held and the
+	bytes copied per write drop several times over a plain LFSV.
+
+    Non-Core Operations Include:
+
+    -Insert a new value into the vector.
+	-Erase one copy of a value from the vector.
+	-Return the value at a specific index within the vector.
+	-Return the number of values within the vector.
+	-Copy every value out of the vector.
+	-Return the # of bytes the current version takes up.
+	-Hand an old/replaced version to the reclaimer.
+
+*/
+/**************************************************************************/
+template <typename Reclaimer = HazardReclaimer>
+class PackedLFSV
+{
+	typedef PackedVersion Version;
+
+	Reclaimer reclaimer;             // Decides when replaced versions may be released
+	std::atomic<Version*> current;   // The current version of the vector
+
+	/*!******************************************************************
+      \brief
+		Returns the block a value should be inserted into.
+
+	  \param version
+	  	The version to search.
+
+	  \param v
+	  	The value.
+
+	  \return
+	  	The index of the last block whose lowest value does not exceed
+		v, or 0 if there is none.
+    ********************************************************************/
+	static std::size_t Route(Version const* version, int v)
+	{
+		std::size_t idx = static_cast<std::size_t>(
+			std::upper_bound(version->lows.begin(), version->lows.end(), v) - version->lows.begin());
+		return idx == 0 ? 0 : idx - 1;
+	}
+
+	/*!******************************************************************
+      \brief
+		Builds the next version of the vector, with the blocks at
+		[first, first + removed) replaced by a list of fresh blocks.
+
+	  \param old
+	  	The version to copy.
+
+	  \param first
+	  	The index of the first block to replace.
+
+	  \param removed
+	  	The # of blocks to replace.
+
+	  \param fresh
+	  	The blocks to put in their place.
+
+	  \param count
+	  	The # of fresh blocks.
+
+	  \return
+	  	The new version.
+    ********************************************************************/
+	static Version* Replace(Version const* old, std::size_t first, std::size_t removed,
+	                        PackedBlock* const* fresh, std::size_t count)
+	{
+		Version* version = new Version(2);
+		std::size_t total = old->blocks.size() - removed + count;
+		version->blocks.reserve(total);
+		version->lows.reserve(total);
+		version->starts.reserve(total + 1);
+
+		version->blocks.insert(version->blocks.end(), old->blocks.begin(), old->blocks.begin() + first);
+		version->blocks.insert(version->blocks.end(), fresh, fresh + count);
+		version->blocks.insert(version->blocks.end(), old->blocks.begin() + first + removed, old->blocks.end());
+
+		version->lows.insert(version->lows.end(), old->lows.begin(), old->lows.begin() + first);
+		for(std::size_t i = 0; i < count; ++i)
+			version->lows.push_back(fresh[i]->low);
+		version->lows.insert(version->lows.end(), old->lows.begin() + first + removed, old->lows.end());
+
+		// Starts before the change are shared; the rest are rebuilt from block counts
+		version->starts.assign(old->starts.begin(), old->starts.begin() + first + 1);
+		for(std::size_t i = first; i < total; ++i)
+			version->starts.push_back(version->starts.back() + version->blocks[i]->count);
+		return version;
+	}
+
+	/*!******************************************************************
+      \brief
+		Publishes a new version in place of an old one, or frees it if
+		another writer got there first.
+
+	  \param old
+	  	The version the new one was built from.
+
+	  \param version
+	  	The new version.
+
+	  \param first
+	  	The index of the first block the new version replaced.
+
+	  \param removed
+	  	The # of blocks it replaced.
+
+	  \param count
+	  	The # of fresh blocks it lists in their place.
+
+	  \return
+	  	Whether the new version was published.
+    ********************************************************************/
+	bool Publish(Version* old, Version* version, std::size_t first, std::size_t removed, std::size_t count)
+	{
+		if(!current.compare_exchange_strong(old, version))
+		{
+			for(std::size_t i = 0; i < count; ++i)
+				DestroyBlock(version->blocks[first + i]);
+			delete version;
+			return false;
+		}
+
+		// No writer can replace old again, so its dropped list is ours to fill
+		old->dropped.assign(old->blocks.begin() + first, old->blocks.begin() + first + removed);
+		old->successor = version;
+		reclaimer.Retire(old, [](void* pointer)
+		{
+			Version::Release(static_cast<Version*>(pointer));
+		});
+		return true;
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the PackedLFSV class.
+    ********************************************************************/
+	PackedLFSV() : reclaimer(), current(new Version())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the PackedLFSV class.
+    ********************************************************************/
+	~PackedLFSV()
+	{
+		// No other thread may be using the container at this point. Older
+		// versions go first, leaving the current one with its own reference
+		reclaimer.Drain();
+
+		Version* version = current.load();
+		for(PackedBlock* block : version->blocks)
+			DestroyBlock(block);
+		delete version;
+	}
+
+	PackedLFSV(PackedLFSV const&) = delete;
+	PackedLFSV& operator=(PackedLFSV const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Insert a new value into the vector. Only the block the value
+		lands in is decoded and re-encoded; it is split in two if it
+		overflows.
+
+      \param v
+        The new value to insert into the vector.
+    ********************************************************************/
+	void Insert(int v)
+	{
+		int values[packedBlock + 1];
+		typename Reclaimer::Guard hp(reclaimer);
+
+		for(;;)
+		{
+			Version* old = hp.Protect(current);
+
+			if(old->blocks.empty())
+			{
+				PackedBlock* block = EncodeBlock(&v, 1);
+				if(Publish(old, Replace(old, 0, 0, &block, 1), 0, 0, 1))
+					break;
+				continue;
+			}
+
+			std::size_t idx = Route(old, v);
+			PackedBlock const* block = old->blocks[idx];
+			DecodeBlock(block, values);
+			unsigned n = block->count;
+			unsigned pos = static_cast<unsigned>(FindUpperBound(values, values + n, v, std::less<int>()) - values);
+			std::copy_backward(values + pos, values + n, values + n + 1);
+			values[pos] = v;
+			++n;
+
+			PackedBlock* fresh[2];
+			std::size_t count = 1;
+			if(n <= packedBlock)
+				fresh[0] = EncodeBlock(values, n);
+			else
+			{
+				fresh[0] = EncodeBlock(values, n / 2);
+				fresh[1] = EncodeBlock(values + n / 2, n - n / 2);
+				count = 2;
+			}
+
+			if(Publish(old, Replace(old, idx, 1, fresh, count), idx, 1, count))
+				break;
+		}
+
+		hp.Clear();
+	}
+
+	/*!******************************************************************
+      \brief
+        Erase one copy of a value from the vector. Only the block holding
+		it is decoded and re-encoded; it is dropped once empty.
+
+      \param v
+        The value to erase.
+
+	  \return
+	  	Whether a copy of the value was found and erased.
+    ********************************************************************/
+	bool Erase(int v)
+	{
+		int values[packedBlock];
+		typename Reclaimer::Guard hp(reclaimer);
+
+		for(;;)
+		{
+			Version* old = hp.Protect(current);
+
+			// Copies of v may start at the end of the block before the one routed to
+			std::size_t idx = static_cast<std::size_t>(
+				std::lower_bound(old->lows.begin(), old->lows.end(), v) - old->lows.begin());
+			if(idx != 0 && old->blocks[idx - 1]->high >= v)
+				--idx;
+			if(idx == old->blocks.size() || old->blocks[idx]->low > v)
+			{
+				hp.Clear();
+				return false;
+			}
+
+			PackedBlock const* block = old->blocks[idx];
+			DecodeBlock(block, values);
+			unsigned n = block->count;
+			int* found = std::lower_bound(values, values + n, v);
+			if(found == values + n || *found != v)
+			{
+				hp.Clear();
+				return false;
+			}
+			std::copy(found + 1, values + n, found);
+			--n;
+
+			PackedBlock* fresh = n != 0 ? EncodeBlock(values, n) : nullptr;
+			std::size_t count = n != 0 ? 1 : 0;
+			if(Publish(old, Replace(old, idx, 1, &fresh, count), idx, 1, count))
+				break;
+		}
+
+		hp.Clear();
+		return true;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the value at a specific index within the vector. The skip
+		index finds the block, and only that block's values up to the
+		index are decoded.
+
+      \param pos
+        The index within the vector to pull a value from. Must be less
+		than size().
+
+      \return
+        The value at the specified position within the vector.
+    ********************************************************************/
+	int operator[](std::size_t pos)
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		Version const* version = hp.Protect(current);
+
+		std::size_t idx = static_cast<std::size_t>(
+			std::upper_bound(version->starts.begin(), version->starts.end(), pos) - version->starts.begin()) - 1;
+		int ret_val = BlockAt(version->blocks[idx], static_cast<unsigned>(pos - version->starts[idx]));
+
+		hp.Clear();
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the number of values within the vector.
+
+      \return
+        The number of values within the current version of the vector.
+    ********************************************************************/
+	std::size_t size()
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		std::size_t ret_val = hp.Protect(current)->starts.back();
+		hp.Clear();
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Copy every value of one version out of the vector, decoding
+		block by block.
+
+      \param out
+        The vector to replace the contents of.
+    ********************************************************************/
+	void Copy(std::vector<int>& out)
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		Version const* version = hp.Protect(current);
+
+		out.resize(version->starts.back());
+		for(std::size_t i = 0; i < version->blocks.size(); ++i)
+			DecodeBlock(version->blocks[i], out.data() + version->starts[i]);
+
+		hp.Clear();
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the # of bytes the current version takes up: its blocks
+		plus its skip index.
+
+      \return
+        The # of bytes.
+    ********************************************************************/
+	std::size_t Bytes()
+	{
+		typename Reclaimer::Guard hp(reclaimer);
+		Version const* version = hp.Protect(current);
+
+		std::size_t ret_val = sizeof(Version) + version->blocks.capacity() * sizeof(PackedBlock*)
+		                    + version->lows.capacity() * sizeof(int)
+		                    + version->starts.capacity() * sizeof(std::size_t);
+		for(PackedBlock const* block : version->blocks)
+			ret_val += block->Bytes();
+
+		hp.Clear();
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the # of replaced versions that have been retired but not
+        yet reclaimed.
+
+      \return
+        The # of versions waiting on the reclaimer.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return reclaimer.Unreclaimed();
+	}
+};
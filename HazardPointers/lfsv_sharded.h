@@ -0,0 +1,786 @@
+/******************************************************************************/
+/*!
+\file   lfsv_sharded.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the definition of the ShardedLFSV class template, a
+	variant of LFSV that splits the key space into range partitions
+	(shards), each with its own root. Writers to different shards never
+	contend on the same CAS, and a write only copies the shard it lands in.
+	Shards split and merge as they grow and shrink, and positional reads
+	are routed through a lock-free prefix-count index.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include "lfsv.h"
+
+const std::size_t shardMax = 4096;         // Size past which a shard splits
+const std::size_t shardMin = shardMax / 8; // Size below which a shard merges with a neighbor
+
+/**************************************************************************/
+/*!
+  \struct Shard
+  \brief
+    One range partition of a ShardedLFSV. Its root is replaced by CAS like
+	an LFSV's, and is tagged (low bit set) once the shard is frozen for a
+	split or merge, after which it never changes again. A shard may be
+	shared by several versions of the directory, so it carries a
+	reference count of the directories that still list it.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct Shard
+{
+	std::atomic<SortedBuffer<T>*> root; // Current version of the shard's values; tagged once frozen
+	std::atomic<int> refs;              // # of directories that list this shard
+
+	/*!******************************************************************
+      \brief
+        Constructor for the Shard struct.
+
+	  \param values
+	  	The shard's first version.
+    ********************************************************************/
+	explicit Shard(SortedBuffer<T>* values) : root(values), refs(1)
+	{}
+};
+
+/**************************************************************************/
+/*!
+  \struct ShardDirectory
+  \brief
+    An immutable list of the shards making up a ShardedLFSV, the lowest
+	value routed to each, and a Fenwick tree over each shard's size. The
+	sizes are the only mutable part: writers publish their shard's new
+	size after every successful write.
+
+*/
+/**************************************************************************/
+template <typename T>
+struct ShardDirectory
+{
+	std::size_t count;                              // # of shards
+	std::vector<Shard<T>*> shards;                  // The shards, in key order
+	std::vector<T> lows;                            // Lowest value routed to each shard; lows[0] is unused
+	std::vector<std::atomic<std::ptrdiff_t>> sizes; // Last size published for each shard
+	std::vector<std::atomic<std::ptrdiff_t>> tree;  // Fenwick tree over sizes, 1-based
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ShardDirectory struct.
+
+	  \param n
+	  	The # of shards the directory will list.
+    ********************************************************************/
+	explicit ShardDirectory(std::size_t n) : count(n), shards(), lows(), sizes(n), tree(n + 1)
+	{
+		shards.reserve(n);
+		lows.reserve(n);
+	}
+
+	/*!******************************************************************
+      \brief
+        Builds the Fenwick tree from the sizes. Must be called before the
+		directory is published.
+    ********************************************************************/
+	void Index()
+	{
+		for(std::size_t k = 1; k <= count; ++k)
+			tree[k].store(0, std::memory_order_relaxed);
+		for(std::size_t k = 1; k <= count; ++k)
+		{
+			std::ptrdiff_t total = tree[k].load(std::memory_order_relaxed)
+			                     + sizes[k - 1].load(std::memory_order_relaxed);
+			tree[k].store(total, std::memory_order_relaxed);
+			std::size_t parent = k + (k & (~k + 1));
+			if(parent <= count)
+				tree[parent].store(tree[parent].load(std::memory_order_relaxed) + total,
+				                   std::memory_order_relaxed);
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Adds a change in size to one shard's entries in the Fenwick tree.
+
+	  \param i
+	  	The shard whose size changed.
+
+	  \param delta
+	  	The change in size.
+    ********************************************************************/
+	void Add(std::size_t i, std::ptrdiff_t delta)
+	{
+		for(std::size_t k = i + 1; k <= count; k += k & (~k + 1))
+			tree[k].fetch_add(delta, std::memory_order_relaxed);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the total # of values across every shard.
+
+	  \return
+	  	The sum of the published sizes.
+    ********************************************************************/
+	std::size_t Total() const
+	{
+		std::ptrdiff_t total = 0;
+		for(std::size_t k = count; k != 0; k -= k & (~k + 1))
+			total += tree[k].load(std::memory_order_relaxed);
+		return total > 0 ? static_cast<std::size_t>(total) : 0;
+	}
+
+	/*!******************************************************************
+      \brief
+        Finds the shard holding a given position, by descending the
+		Fenwick tree.
+
+	  \param pos
+	  	The position to find.
+
+	  \param offset
+	  	Set to the position within the returned shard.
+
+	  \return
+	  	The index of the shard holding the position.
+    ********************************************************************/
+	std::size_t Locate(std::size_t pos, std::size_t& offset) const
+	{
+		std::size_t step = 1;
+		while(step * 2 <= count)
+			step *= 2;
+
+		std::size_t idx = 0;
+		std::ptrdiff_t remaining = static_cast<std::ptrdiff_t>(pos);
+		for(; step != 0; step /= 2)
+		{
+			if(idx + step > count)
+				continue;
+			std::ptrdiff_t below = tree[idx + step].load(std::memory_order_relaxed);
+			if(below <= remaining)
+			{
+				idx += step;
+				remaining -= below;
+			}
+		}
+
+		// Past the end (or stale counts), so start from the last shard
+		if(idx >= count)
+		{
+			idx = count - 1;
+			remaining = static_cast<std::ptrdiff_t>(pos);
+			for(std::size_t k = idx; k != 0; k -= k & (~k + 1))
+				remaining -= tree[k].load(std::memory_order_relaxed);
+		}
+		offset = remaining > 0 ? static_cast<std::size_t>(remaining) : 0;
+		return idx;
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class ShardedLFSV
+  \brief
+    A lock-free implementation of an automatically-sorting vector, split
+	into range-partitioned shards. Sorts elements from least to greatest
+	according to Compare.
+
+	Each shard is an independent sorted version replaced by CAS, so a
+	write copies only its own shard, and writers to different shards do
+	not conflict. When a shard grows past shardMax (or shrinks below
+	shardMin) it is frozen and replaced, together with a neighbor when
+	merging, by a new directory listing the rebalanced shards. Any writer
+	that runs into a frozen shard finishes the restructure itself rather
+	than waiting, so no thread ever blocks on another.
+
+	Positional reads are located through a Fenwick tree of shard sizes.
+	The tree is exact whenever writers are quiescent; under concurrent
+	writes, positions are only as stable as the data itself.
+
+    Non-Core Operations Include:
+
+    -Insert a new value into the vector.
+	-Erase one copy of a value from the vector.
+    -Return the value at a specific index within the vector.
+	-Return the number of values within the vector.
+	-Return the number of shards.
+	-Split or merge a frozen shard, helping whichever thread froze it.
+
+*/
+/**************************************************************************/
+template <typename T = int, typename Compare = std::less<T>, typename Reclaimer = HazardReclaimer>
+class ShardedLFSV
+{
+	typedef SortedBuffer<T> Buffer;         // One version of a shard's values
+	typedef Shard<T> Part;                  // One range partition
+	typedef ShardDirectory<T> Directory;    // One version of the list of shards
+	typedef typename Reclaimer::Guard Guard;
+
+	Compare comp;                       // Ordering of the values
+	Reclaimer directories;              // Decides when replaced directories may be released
+	Reclaimer versions;                 // Decides when replaced shard versions may be released
+	std::atomic<Directory*> directory;  // The current list of shards
+
+	/*!******************************************************************
+      \brief
+		Checks whether a shard's root has been frozen.
+
+	  \param root
+	  	The root to check.
+
+	  \return
+	  	Whether the root carries the frozen tag.
+    ********************************************************************/
+	static bool Frozen(Buffer* root)
+	{
+		return (reinterpret_cast<std::uintptr_t>(root) & 1) != 0;
+	}
+
+	/*!******************************************************************
+      \brief
+		Removes the frozen tag from a shard's root.
+
+	  \param root
+	  	The root, tagged or not.
+
+	  \return
+	  	The version the root points to.
+    ********************************************************************/
+	static Buffer* Strip(Buffer* root)
+	{
+		return reinterpret_cast<Buffer*>(reinterpret_cast<std::uintptr_t>(root) & ~std::uintptr_t(1));
+	}
+
+	/*!******************************************************************
+      \brief
+		Drops a directory's reference to a shard, deleting the shard and
+		its final version once no directory lists it.
+
+	  \param shard
+	  	The shard to release.
+    ********************************************************************/
+	static void ReleaseShard(Part* shard)
+	{
+		if(shard->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		delete Strip(shard->root.load());
+		delete shard;
+	}
+
+	/*!******************************************************************
+      \brief
+		Deletes a directory, releasing every shard it lists.
+
+	  \param pointer
+	  	The directory to delete.
+    ********************************************************************/
+	static void ReleaseDirectory(void* pointer)
+	{
+		Directory* dir = static_cast<Directory*>(pointer);
+		for(Part* shard : dir->shards)
+			ReleaseShard(shard);
+		delete dir;
+	}
+
+	/*!******************************************************************
+      \brief
+		Returns the shard whose range holds a value.
+
+	  \param dir
+	  	The directory to search.
+
+	  \param v
+	  	The value to route.
+
+	  \return
+	  	The index of the shard within the directory.
+    ********************************************************************/
+	std::size_t Route(Directory const* dir, T const& v) const
+	{
+		std::size_t idx = static_cast<std::size_t>(
+			std::upper_bound(dir->lows.begin() + 1, dir->lows.end(), v, comp) - dir->lows.begin());
+		return idx - 1;
+	}
+
+	/*!******************************************************************
+      \brief
+		Freezes a shard, so that its current version is its last.
+
+	  \param shard
+	  	The shard to freeze.
+    ********************************************************************/
+	static void Freeze(Part* shard)
+	{
+		Buffer* current = shard->root.load();
+		while(!Frozen(current))
+		{
+			Buffer* tagged = reinterpret_cast<Buffer*>(reinterpret_cast<std::uintptr_t>(current) | 1);
+			if(shard->root.compare_exchange_weak(current, tagged))
+				return;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+		Publishes a shard's current size to a directory's prefix-count
+		index. Repeats until the size it published is still current, so a
+		slower writer can never leave a stale size behind.
+
+	  \param vg
+	  	The calling thread's guard over shard versions.
+
+	  \param dir
+	  	The (protected) directory listing the shard.
+
+	  \param i
+	  	The index of the shard within the directory.
+    ********************************************************************/
+	void Publish(Guard& vg, Directory* dir, std::size_t i)
+	{
+		Part* shard = dir->shards[i];
+		for(;;)
+		{
+			Buffer* root = vg.Protect(shard->root);
+			std::ptrdiff_t size = static_cast<std::ptrdiff_t>(Strip(root)->size());
+			std::ptrdiff_t previous = dir->sizes[i].exchange(size);
+			if(size != previous)
+				dir->Add(i, size - previous);
+			if(shard->root.load() == root)
+				break;
+		}
+		vg.Clear();
+	}
+
+	/*!******************************************************************
+      \brief
+		Publishes a written shard's size to the current directory, and to
+		any directory that replaced it in the meantime.
+
+	  \param dg
+	  	The calling thread's guard over directories.
+
+	  \param vg
+	  	The calling thread's guard over shard versions.
+
+	  \param dir
+	  	The (protected) directory the write went through.
+
+	  \param shard
+	  	The shard that was written to.
+
+	  \param v
+	  	The value written, used to find the shard again.
+
+	  \return
+	  	The (protected) current directory, or nullptr if the shard has
+		since been replaced.
+    ********************************************************************/
+	Directory* Track(Guard& dg, Guard& vg, Directory* dir, Part* shard, T const& v)
+	{
+		std::size_t i = Route(dir, v);
+		for(;;)
+		{
+			Publish(vg, dir, i);
+
+			Directory* current = dg.Protect(directory);
+			if(current == dir)
+				return dir;
+
+			dir = current;
+			i = Route(dir, v);
+			if(dir->shards[i] != shard)
+				return nullptr;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+		Replaces a frozen shard (and, unless it has grown too large, one
+		of its neighbors) with freshly balanced shards, and publishes the
+		result as a new directory. Any thread may call this for any frozen
+		shard; if another thread publishes first, the work is discarded.
+
+	  \param dg
+	  	The calling thread's guard over directories.
+
+	  \param vg
+	  	The calling thread's guard over shard versions.
+
+	  \param dir
+	  	The (protected) directory listing the frozen shard.
+
+	  \param i
+	  	The index of the frozen shard within the directory.
+    ********************************************************************/
+	void Restructure(Guard& dg, Guard& vg, Directory* dir, std::size_t i)
+	{
+		// Decide which run of shards to replace
+		std::size_t first = i;
+		std::size_t last = i + 1;
+		if(Strip(dir->shards[i]->root.load())->size() <= shardMax && dir->count > 1)
+		{
+			std::size_t j = i + 1 < dir->count ? i + 1 : i - 1;
+			Freeze(dir->shards[j]);
+			first = std::min(i, j);
+			last = std::max(i, j) + 1;
+		}
+
+		// Frozen versions never change and live as long as their shard
+		std::vector<T> merged;
+		for(std::size_t k = first; k < last; ++k)
+		{
+			Buffer const* values = Strip(dir->shards[k]->root.load());
+			merged.insert(merged.end(), values->begin(), values->end());
+		}
+
+		// Cut the run into pieces of about half the maximum, never between equal values
+		std::size_t total = merged.size();
+		std::size_t pieces = total / (shardMax / 2);
+		if(pieces == 0)
+			pieces = 1;
+
+		std::vector<std::size_t> cuts(1, 0);
+		for(std::size_t p = 1; p < pieces; ++p)
+		{
+			std::size_t cut = total * p / pieces;
+			std::size_t prev = cuts.back();
+			if(cut <= prev)
+				continue;
+			auto begin = merged.begin() + prev;
+			cut = static_cast<std::size_t>(std::lower_bound(begin, merged.end(), merged[cut], comp) - merged.begin());
+			if(cut == prev)
+				cut = static_cast<std::size_t>(std::upper_bound(begin, merged.end(), merged[cut], comp) - merged.begin());
+			if(cut == total)
+				break;
+			cuts.push_back(cut);
+		}
+		cuts.push_back(total);
+
+		// Share every shard outside the run, and build new ones for it
+		std::size_t built = cuts.size() - 1;
+		Directory* fresh = new Directory(dir->count - (last - first) + built);
+		std::size_t slot = 0;
+		for(std::size_t k = 0; k < first; ++k, ++slot)
+		{
+			dir->shards[k]->refs.fetch_add(1, std::memory_order_relaxed);
+			fresh->shards.push_back(dir->shards[k]);
+			fresh->lows.push_back(dir->lows[k]);
+			fresh->sizes[slot].store(dir->sizes[k].load(), std::memory_order_relaxed);
+		}
+		for(std::size_t p = 0; p < built; ++p, ++slot)
+		{
+			Buffer* values = new Buffer();
+			values->append(merged.data() + cuts[p], merged.data() + cuts[p + 1]);
+			fresh->shards.push_back(new Part(values));
+			fresh->lows.push_back(p == 0 ? dir->lows[first] : merged[cuts[p]]);
+			fresh->sizes[slot].store(static_cast<std::ptrdiff_t>(values->size()), std::memory_order_relaxed);
+		}
+		for(std::size_t k = last; k < dir->count; ++k, ++slot)
+		{
+			dir->shards[k]->refs.fetch_add(1, std::memory_order_relaxed);
+			fresh->shards.push_back(dir->shards[k]);
+			fresh->lows.push_back(dir->lows[k]);
+			fresh->sizes[slot].store(dir->sizes[k].load(), std::memory_order_relaxed);
+		}
+		fresh->Index();
+
+		Directory* expected = dir;
+		if(!directory.compare_exchange_strong(expected, fresh))
+		{
+			// Someone else restructured first; nothing saw this copy
+			ReleaseDirectory(fresh);
+			return;
+		}
+
+		dg.Clear();
+		directories.Retire(dir, &ShardedLFSV::ReleaseDirectory);
+
+		// Sizes copied for shared shards may have missed in-flight writes
+		Directory* current = dg.Protect(directory);
+		for(std::size_t k = 0; k < current->count; ++k)
+			Publish(vg, current, k);
+	}
+
+	/*!******************************************************************
+      \brief
+		Freezes a shard that has outgrown (or shrunk out of) its bounds,
+		and restructures until no directory lists it anymore.
+
+	  \param dg
+	  	The calling thread's guard over directories.
+
+	  \param vg
+	  	The calling thread's guard over shard versions.
+
+	  \param shard
+	  	The shard to restructure.
+
+	  \param v
+	  	A value within the shard's range, used to find it again.
+    ********************************************************************/
+	void Rebalance(Guard& dg, Guard& vg, Part* shard, T const& v)
+	{
+		Freeze(shard);
+		for(;;)
+		{
+			Directory* dir = dg.Protect(directory);
+			std::size_t i = Route(dir, v);
+			if(dir->shards[i] != shard)
+				return;
+			Restructure(dg, vg, dir, i);
+		}
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the ShardedLFSV class.
+
+	  \param compare
+	  	The ordering to sort values by.
+    ********************************************************************/
+	ShardedLFSV(Compare const& compare = Compare()) : comp(compare), directories(), versions(), directory(nullptr)
+	{
+		Directory* dir = new Directory(1);
+		dir->shards.push_back(new Part(new Buffer()));
+		dir->lows.push_back(T());
+		dir->Index();
+		directory.store(dir);
+	}
+
+	/*!******************************************************************
+      \brief
+        Destructor for the ShardedLFSV class.
+    ********************************************************************/
+	~ShardedLFSV()
+	{
+		ReleaseDirectory(directory.load());
+
+		// No other thread may be using the container at this point
+		directories.Drain();
+		versions.Drain();
+	}
+
+	ShardedLFSV(ShardedLFSV const&) = delete;
+	ShardedLFSV& operator=(ShardedLFSV const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Insert a new value into the vector.
+
+      \param v
+        Reference to the new value to insert into the vector.
+    ********************************************************************/
+	void Insert(T const& v)
+	{
+		Buffer* pdata_new = new Buffer(); // Copy of the shard with v inserted
+		Buffer* pdata_old = nullptr;      // Version the copy was built from
+		Part* shard = nullptr;            // Shard the value was written to
+		Directory* dir = nullptr;         // Directory the shard was found through
+		std::size_t size = 0;             // Size of the shard after the insert
+
+		Guard dg(directories);
+		Guard vg(versions);
+
+		for(;;)
+		{
+			dir = dg.Protect(directory);
+			std::size_t i = Route(dir, v);
+			shard = dir->shards[i];
+			pdata_old = vg.Protect(shard->root);
+
+			// Finish whatever split or merge froze this shard, then retry
+			if(Frozen(pdata_old))
+			{
+				Restructure(dg, vg, dir, i);
+				continue;
+			}
+
+			std::size_t pos = FindUpperBound(pdata_old->begin(), pdata_old->end(), v, comp) - pdata_old->begin();
+			pdata_new->assign(*pdata_old, pos, v);
+			size = pdata_new->size(); // Not safe to read once published
+			if(shard->root.compare_exchange_strong(pdata_old, pdata_new))
+				break;
+		}
+
+		// Release the guard and retire the "old" version after it has been replaced
+		vg.Clear();
+		versions.Retire(pdata_old, [](void* pointer)
+		{
+			delete static_cast<Buffer*>(pointer);
+		});
+
+		if(Track(dg, vg, dir, shard, v) && size > shardMax)
+			Rebalance(dg, vg, shard, v);
+	}
+
+	/*!******************************************************************
+      \brief
+        Erase one copy of a value from the vector.
+
+      \param v
+        Reference to the value to erase.
+
+	  \return
+	  	Whether a copy of the value was found and erased.
+    ********************************************************************/
+	bool Erase(T const& v)
+	{
+		Buffer* pdata_new = nullptr; // Copy of the shard with v erased
+		Buffer* pdata_old = nullptr; // Version the copy was built from
+		Part* shard = nullptr;       // Shard the value was erased from
+		Directory* dir = nullptr;    // Directory the shard was found through
+		std::size_t size = 0;        // Size of the shard after the erase
+
+		Guard dg(directories);
+		Guard vg(versions);
+
+		for(;;)
+		{
+			dir = dg.Protect(directory);
+			std::size_t i = Route(dir, v);
+			shard = dir->shards[i];
+			pdata_old = vg.Protect(shard->root);
+
+			if(Frozen(pdata_old))
+			{
+				Restructure(dg, vg, dir, i);
+				continue;
+			}
+
+			T const* found = std::lower_bound(pdata_old->begin(), pdata_old->end(), v, comp);
+			if(found == pdata_old->end() || comp(v, *found))
+			{
+				delete pdata_new;
+				return false;
+			}
+
+			if(!pdata_new)
+				pdata_new = new Buffer();
+			pdata_new->clear();
+			pdata_new->reserve(pdata_old->size() - 1);
+			pdata_new->append(pdata_old->begin(), found);
+			pdata_new->append(found + 1, pdata_old->end());
+			size = pdata_new->size();
+			if(shard->root.compare_exchange_strong(pdata_old, pdata_new))
+				break;
+		}
+
+		vg.Clear();
+		versions.Retire(pdata_old, [](void* pointer)
+		{
+			delete static_cast<Buffer*>(pointer);
+		});
+
+		dir = Track(dg, vg, dir, shard, v);
+		if(dir && size < shardMin && dir->count > 1)
+			Rebalance(dg, vg, shard, v);
+		return true;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the value at a specific index within the vector.
+
+      \param pos
+        The index within the vector to pull a value from. Must be less
+		than size(). While erases race the read, a position past the end
+		of the data reads the last value instead.
+
+      \return
+        The value at the specified position within the vector.
+
+      \exception std::out_of_range
+        If every shard is empty.
+    ********************************************************************/
+	T operator[](std::size_t pos)
+	{
+		Guard dg(directories);
+		Guard vg(versions);
+
+		Directory* dir = dg.Protect(directory);
+		std::size_t offset = 0;
+		std::size_t i = dir->Locate(pos, offset);
+
+		// Step past any shard whose published size ran ahead of its data
+		Buffer const* values = Strip(vg.Protect(dir->shards[i]->root));
+		while(offset >= values->size() && i + 1 < dir->count)
+		{
+			offset -= values->size();
+			values = Strip(vg.Protect(dir->shards[++i]->root));
+		}
+
+		// Ran off the end: fall back to the last value, stepping back past
+		// any shard emptied by an erase that has not been merged away yet
+		if(offset >= values->size())
+		{
+			while(values->size() == 0 && i > 0)
+				values = Strip(vg.Protect(dir->shards[--i]->root));
+			if(values->size() == 0)
+				throw std::out_of_range("ShardedLFSV: index into an empty vector");
+			offset = values->size() - 1;
+		}
+
+		T ret_val = (*values)[offset];
+
+		vg.Clear();
+		dg.Clear();
+
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the number of values within the vector.
+
+      \return
+        The sum of every shard's published size.
+    ********************************************************************/
+	std::size_t size()
+	{
+		Guard dg(directories);
+		std::size_t ret_val = dg.Protect(directory)->Total();
+		dg.Clear();
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the number of shards the values are currently split into.
+
+      \return
+        The # of shards listed by the current directory.
+    ********************************************************************/
+	std::size_t Shards()
+	{
+		Guard dg(directories);
+		std::size_t ret_val = dg.Protect(directory)->count;
+		dg.Clear();
+		return ret_val;
+	}
+
+	/*!******************************************************************
+      \brief
+        Return the # of replaced directories and shard versions that have
+        been retired but not yet reclaimed.
+
+      \return
+        The # of pointers waiting on the reclaimers.
+    ********************************************************************/
+	std::size_t Unreclaimed() const
+	{
+		return directories.Unreclaimed() + versions.Unreclaimed();
+	}
+};
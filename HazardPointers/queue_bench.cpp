@@ -0,0 +1,231 @@
+/******************************************************************************/
+/*!
+\file   queue_bench.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains a small benchmark driver comparing the lock-free
+	MSQueue and TreiberStack, under each reclamation policy, against a
+	std::deque behind a mutex, as the thread count grows. Every thread
+	runs pairs of one add and one take, and the values taken are summed
+	to check that none were lost or duplicated.
+
+	Build with: g++ -std=c++17 -O2 -pthread queue_bench.cpp -o queue_bench
+	Usage:      queue_bench [pairs] [max threads]
+
+*/
+/******************************************************************************/
+
+#include "hazard_queue.h"
+#include <deque>    // std::deque
+#include <iostream> // std::cout
+#include <chrono>   // std::chrono
+#include <cstdlib>  // std::atoi
+
+/**************************************************************************/
+/*!
+  \class LockedDeque
+  \brief
+    The baseline: a std::deque guarded by a single mutex, taking from
+	the front (FIFO) or the back (LIFO).
+
+*/
+/**************************************************************************/
+template <typename T, bool Lifo>
+class LockedDeque
+{
+	std::mutex mutex;     // Guards values
+	std::deque<T> values; // The values added and not yet taken
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Add a value to the back of the deque.
+
+      \param v
+        The value to add.
+    ********************************************************************/
+	void Add(T const& v)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		values.push_back(v);
+	}
+
+	/*!******************************************************************
+      \brief
+        Take a value from the front, or from the back if Lifo.
+
+      \param v
+        Where to move the value to.
+
+      \return
+        Whether there was a value to take.
+    ********************************************************************/
+	bool Take(T& v)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(values.empty())
+			return false;
+
+		if(Lifo)
+		{
+			v = std::move(values.back());
+			values.pop_back();
+		}
+		else
+		{
+			v = std::move(values.front());
+			values.pop_front();
+		}
+		return true;
+	}
+};
+
+/*!******************************************************************
+  \brief
+    Runs add/take pairs on one container from several threads, then
+	takes whatever is left and checks every value came out exactly once.
+
+  \param name
+	Label to print alongside the results.
+
+  \param pairs
+	# of add/take pairs run by each thread.
+
+  \param threads
+	# of threads to run them on.
+
+  \param add
+	Adds a value to the container.
+
+  \param take
+	Takes a value from the container; returns whether there was one.
+********************************************************************/
+template <typename Container, typename Add, typename Take>
+void RunPairs(char const* name, int pairs, int threads, Add add, Take take)
+{
+	Container container;
+	std::atomic<long long> taken(0);
+	std::atomic<long long> sum(0);
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&container, &taken, &sum, &add, &take, pairs, t]()
+		{
+			long long localTaken = 0;
+			long long localSum = 0;
+			long long value = 0;
+			for(int i = 0; i < pairs; ++i)
+			{
+				add(container, static_cast<long long>(t) * pairs + i + 1);
+				if(take(container, value))
+				{
+					++localTaken;
+					localSum += value;
+				}
+			}
+			taken += localTaken;
+			sum += localSum;
+		});
+	}
+	for(std::thread& worker : workers)
+		worker.join();
+	auto end = std::chrono::steady_clock::now();
+
+	long long value = 0;
+	while(take(container, value))
+	{
+		++taken;
+		sum += value;
+	}
+
+	long long total = static_cast<long long>(pairs) * threads;
+	bool exact = taken == total && sum == total * (total + 1) / 2;
+	double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+	std::cout << name << ": " << ms << " ms, "
+	          << 2 * total / ms / 1000.0 << " Mops/s for " << total << " pairs on "
+	          << threads << " thread(s)" << (exact ? "" : " [LOST OR DUPLICATED]") << std::endl;
+}
+
+/*!******************************************************************
+  \brief
+    Runs the queue comparison for one thread count.
+
+  \param pairs
+	# of add/take pairs run by each thread.
+
+  \param threads
+	# of threads to run them on.
+********************************************************************/
+void RunQueues(int pairs, int threads)
+{
+	auto enqueue = [](auto& queue, long long v) { queue.Enqueue(v); };
+	auto dequeue = [](auto& queue, long long& v) { return queue.Dequeue(v); };
+
+	RunPairs<MSQueue<long long, HazardReclaimer>>("queue hazard", pairs, threads, enqueue, dequeue);
+	RunPairs<MSQueue<long long, EpochReclaimer>>("queue epoch ", pairs, threads, enqueue, dequeue);
+	RunPairs<MSQueue<long long, SharedHazardReclaimer>>("queue shared", pairs, threads, enqueue, dequeue);
+	RunPairs<LockedDeque<long long, false>>("queue mutex ", pairs, threads,
+		[](LockedDeque<long long, false>& queue, long long v) { queue.Add(v); },
+		[](LockedDeque<long long, false>& queue, long long& v) { return queue.Take(v); });
+}
+
+/*!******************************************************************
+  \brief
+    Runs the stack comparison for one thread count.
+
+  \param pairs
+	# of add/take pairs run by each thread.
+
+  \param threads
+	# of threads to run them on.
+********************************************************************/
+void RunStacks(int pairs, int threads)
+{
+	auto push = [](auto& stack, long long v) { stack.Push(v); };
+	auto pop = [](auto& stack, long long& v) { return stack.Pop(v); };
+
+	RunPairs<TreiberStack<long long, HazardReclaimer>>("stack hazard", pairs, threads, push, pop);
+	RunPairs<TreiberStack<long long, EpochReclaimer>>("stack epoch ", pairs, threads, push, pop);
+	RunPairs<TreiberStack<long long, SharedHazardReclaimer>>("stack shared", pairs, threads, push, pop);
+	RunPairs<LockedDeque<long long, true>>("stack mutex ", pairs, threads,
+		[](LockedDeque<long long, true>& stack, long long v) { stack.Add(v); },
+		[](LockedDeque<long long, true>& stack, long long& v) { return stack.Take(v); });
+}
+
+/*!******************************************************************
+  \brief
+    Main function for the queue benchmark driver.
+
+  \param argc
+	# of command line arguments.
+
+  \param argv
+	Command line arguments: [pairs] [max threads].
+
+  \return
+	0 on success.
+********************************************************************/
+int main(int argc, char* argv[])
+{
+	int pairs = argc > 1 ? std::atoi(argv[1]) : 200000;
+	int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+
+	for(int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		RunQueues(pairs / threads, threads);
+		RunStacks(pairs / threads, threads);
+	}
+
+	return 0;
+}
@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file   check.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the CHECK macro shared by the unit tests. A failed
+	check prints where it failed and is counted; each test's main returns
+	Failures() so the runner sees a non-zero exit status.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include <atomic>   // std::atomic
+#include <iostream> // std::cerr
+
+/*!******************************************************************
+  \brief
+    Returns the # of failed checks, shared by every thread of a test.
+
+  \return
+	The counter.
+********************************************************************/
+inline std::atomic<int>& Failures()
+{
+	static std::atomic<int> failures(0);
+	return failures;
+}
+
+/*!******************************************************************
+  \brief
+    Checks a condition, printing it along with its file and line if it
+	does not hold. Returns whether it held, so a test can stop early.
+********************************************************************/
+#define CHECK(condition) \
+	((condition) ? true : (++Failures(), \
+	 std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl, false))
@@ -0,0 +1,125 @@
+/******************************************************************************/
+/*!
+\file   lfsv_combining_test.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the unit tests for LFSV's combining write path
+	when the combiner throws. Several writers insert values whose copy
+	throws now and then; every insert must either return having been
+	applied or throw having not been, no writer may be left waiting on
+	a combiner that gave up, and the container must end up holding
+	exactly the values whose inserts returned.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_combining_test.cpp -o lfsv_combining_test
+	(or make test / make test-asan / make test-tsan from the parent directory)
+
+*/
+/******************************************************************************/
+
+#include "../lfsv.h"
+#include "check.h"
+#include <set>     // std::multiset
+#include <random>  // std::mt19937
+#include <cstdio>  // std::printf
+
+/*!
+  \struct Fragile
+  \brief
+    A value whose copy constructor throws when the value is negative,
+	standing in for a T whose copy can fail.
+*/
+struct Fragile
+{
+	int value = 0; // The value; negative ones refuse to be copied
+
+	Fragile() = default;
+	explicit Fragile(int v) : value(v) {}
+	Fragile(Fragile const& other) : value(other.value)
+	{
+		if(value < 0)
+			throw std::runtime_error("Fragile: copy refused");
+	}
+	Fragile& operator=(Fragile const&) = default;
+
+	bool operator<(Fragile const& other) const
+	{
+		return value < other.value;
+	}
+};
+
+/*!******************************************************************
+  \brief
+    Has several writers insert through the combining path, one value in
+	ten of them refusing to be copied, and checks every insert either
+	went in or threw, never both.
+
+  \param writers
+	# of writer threads.
+********************************************************************/
+void ThrowingCopies(int writers)
+{
+	LFSV<Fragile> container(WriteMode::Combining);
+	std::vector<std::multiset<int>> applied(static_cast<std::size_t>(writers));
+	std::vector<std::thread> threads;
+
+	for(int t = 0; t < writers; ++t)
+	{
+		threads.emplace_back([&container, &applied, t]()
+		{
+			std::mt19937 rng(static_cast<unsigned>(t) + 1);
+			for(int i = 0; i < 2000; ++i)
+			{
+				int value = static_cast<int>(rng() % 1000);
+				if(rng() % 10 == 0)
+					value = -1 - value;
+				try
+				{
+					container.Insert(Fragile(value));
+					CHECK(value >= 0);
+					applied[static_cast<std::size_t>(t)].insert(value);
+				}
+				catch(std::runtime_error const&)
+				{
+				}
+			}
+		});
+	}
+	for(std::thread& thread : threads)
+		thread.join();
+
+	std::multiset<int> all;
+	for(std::multiset<int> const& model : applied)
+		all.insert(model.begin(), model.end());
+
+	LFSV<Fragile>::Snapshot snapshot = container.GetSnapshot();
+	CHECK(snapshot.size() == all.size());
+	CHECK(std::equal(snapshot.begin(), snapshot.end(), all.begin(),
+	                 [](Fragile const& a, int b) { return a.value == b; }));
+
+	// The combiner role was released, so a plain insert still goes through
+	container.Insert(Fragile(5));
+	CHECK(container.GetSnapshot().size() == all.size() + 1);
+}
+
+/*!******************************************************************
+  \brief
+    Main function for the combining failure tests.
+
+  \return
+	The # of failed checks.
+********************************************************************/
+int main()
+{
+	ThrowingCopies(1);
+	ThrowingCopies(4);
+
+	std::printf("lfsv_combining_test: %d failure(s)\n", Failures().load());
+	return Failures().load() != 0;
+}
@@ -0,0 +1,327 @@
+/******************************************************************************/
+/*!
+\file   lfsv_erase_test.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the unit tests for LFSV's Erase family: Erase,
+	EraseRange, EraseIf and EraseIfAndInsert. Every result is checked
+	against a std::multiset model, with heavy duplicates, on empty
+	containers, under every write mode and reclamation policy, and with
+	several writers at once, each owning its own range of keys so its
+	model stays exact while the others run.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_erase_test.cpp -o lfsv_erase_test
+	(or make test / make test-asan / make test-tsan from the parent directory)
+
+*/
+/******************************************************************************/
+
+#include "../lfsv.h"
+#include "check.h"
+#include <set>     // std::multiset
+#include <random>  // std::mt19937
+#include <cstdio>  // std::printf
+
+const int keySpan = 40; // # of distinct keys each writer uses, so duplicates pile up
+
+/*!******************************************************************
+  \brief
+    Checks that a container holds exactly the values of a model.
+
+  \param container
+	The container to check.
+
+  \param model
+	The values it should hold.
+
+  \return
+	Whether they match.
+********************************************************************/
+template <typename Vector>
+bool Matches(Vector& container, std::multiset<int> const& model)
+{
+	typename Vector::Snapshot snapshot = container.GetSnapshot();
+	return snapshot.size() == model.size() && std::equal(snapshot.begin(), snapshot.end(), model.begin());
+}
+
+/*!******************************************************************
+  \brief
+    Erases every value of a model matching a predicate.
+
+  \param model
+	The model to erase from.
+
+  \param pred
+	Returns whether to erase a value.
+
+  \return
+	The # of values erased.
+********************************************************************/
+template <typename Predicate>
+std::size_t ModelEraseIf(std::multiset<int>& model, Predicate pred)
+{
+	std::size_t erased = 0;
+	for(auto it = model.begin(); it != model.end();)
+	{
+		if(pred(*it))
+		{
+			it = model.erase(it);
+			++erased;
+		}
+		else
+			++it;
+	}
+	return erased;
+}
+
+/*!******************************************************************
+  \brief
+    Runs one random write on both a container and its model, within the
+	keys [base, base + keySpan), and checks the container returned what
+	the model says it should.
+
+  \param container
+	The container to write to.
+
+  \param model
+	The model of the caller's keys within the container.
+
+  \param rng
+	The random source.
+
+  \param base
+	The lowest key to use.
+********************************************************************/
+template <typename Vector>
+void RandomWrite(Vector& container, std::multiset<int>& model, std::mt19937& rng, int base)
+{
+	int a = base + static_cast<int>(rng() % keySpan);
+	int b = base + static_cast<int>(rng() % keySpan);
+	int mod = 2 + static_cast<int>(rng() % 4);
+	int rem = static_cast<int>(rng() % mod);
+	auto pred = [base, mod, rem](int value)
+	{
+		return value >= base && value < base + keySpan && value % mod == rem;
+	};
+
+	switch(rng() % 7)
+	{
+		case 0:
+		case 1:
+			container.Insert(a);
+			model.insert(a);
+			break;
+
+		case 2:
+		{
+			int batch[8];
+			for(int& value : batch)
+				value = base + static_cast<int>(rng() % keySpan);
+			container.InsertBatch(batch, 8);
+			model.insert(batch, batch + 8);
+			break;
+		}
+
+		case 3:
+		{
+			auto found = model.find(a);
+			bool expected = found != model.end();
+			if(expected)
+				model.erase(found);
+			CHECK(container.Erase(a) == expected);
+			break;
+		}
+
+		case 4:
+		{
+			// Includes empty and backwards ranges, which erase nothing
+			std::size_t expected = 0;
+			if(a < b)
+			{
+				auto first = model.lower_bound(a);
+				auto last = model.lower_bound(b);
+				expected = static_cast<std::size_t>(std::distance(first, last));
+				model.erase(first, last);
+			}
+			CHECK(container.EraseRange(a, b) == expected);
+			break;
+		}
+
+		case 5:
+			CHECK(container.EraseIf(pred) == ModelEraseIf(model, pred));
+			break;
+
+		case 6:
+		{
+			std::size_t expected = ModelEraseIf(model, pred);
+			model.insert(a);
+			CHECK(container.EraseIfAndInsert(pred, a) == expected);
+			break;
+		}
+	}
+}
+
+/*!******************************************************************
+  \brief
+    Checks every erase on an empty container, and that erasing the last
+	copy of each value empties it again.
+
+  \param mode
+	The write mode to test.
+********************************************************************/
+template <typename Reclaimer>
+void EmptyTest(WriteMode mode)
+{
+	LFSV<int, std::less<int>, std::allocator<int>, Reclaimer> container(mode);
+	std::multiset<int> model;
+
+	CHECK(!container.Erase(5));
+	CHECK(container.EraseRange(0, 100) == 0);
+	CHECK(container.EraseRange(100, 0) == 0);
+	CHECK(container.EraseIf([](int) { return true; }) == 0);
+	CHECK(Matches(container, model));
+
+	// Erasing everything while inserting leaves just the new value
+	CHECK(container.EraseIfAndInsert([](int) { return true; }, 7) == 0);
+	model.insert(7);
+	CHECK(Matches(container, model));
+
+	for(int copy = 0; copy < 3; ++copy)
+	{
+		container.Insert(3);
+		model.insert(3);
+	}
+	CHECK(container.EraseIfAndInsert([](int value) { return value == 7; }, 3) == 1);
+	model.erase(7);
+	model.insert(3);
+	CHECK(Matches(container, model));
+
+	// Duplicates go one copy at a time
+	for(int copy = 4; copy > 0; --copy)
+	{
+		CHECK(container.Erase(3));
+		model.erase(model.find(3));
+		CHECK(Matches(container, model));
+	}
+	CHECK(!container.Erase(3));
+	CHECK(container.GetSnapshot().empty());
+}
+
+/*!******************************************************************
+  \brief
+    Runs random writes on one thread, checking the whole container
+	against the model after each.
+
+  \param mode
+	The write mode to test.
+
+  \param seed
+	Seed for the random writes.
+********************************************************************/
+template <typename Reclaimer>
+void ModelTest(WriteMode mode, unsigned seed)
+{
+	LFSV<int, std::less<int>, std::allocator<int>, Reclaimer> container(mode);
+	std::multiset<int> model;
+	std::mt19937 rng(seed);
+
+	for(int i = 0; i < 3000; ++i)
+	{
+		RandomWrite(container, model, rng, 0);
+		if(!CHECK(Matches(container, model)))
+			return;
+	}
+}
+
+/*!******************************************************************
+  \brief
+    Runs random writes from several threads at once, each within its own
+	keys, while a reader checks every snapshot it pins is sorted. Each
+	writer's results are checked against its own model as it goes, and
+	the container against the union of them at the end.
+
+  \param mode
+	The write mode to test.
+
+  \param writers
+	# of writer threads.
+********************************************************************/
+template <typename Reclaimer>
+void ConcurrentTest(WriteMode mode, int writers)
+{
+	LFSV<int, std::less<int>, std::allocator<int>, Reclaimer> container(mode);
+	std::vector<std::multiset<int>> models(static_cast<std::size_t>(writers));
+	std::atomic<int> running(writers);
+	std::vector<std::thread> threads;
+
+	for(int t = 0; t < writers; ++t)
+	{
+		threads.emplace_back([&container, &models, &running, t]()
+		{
+			std::mt19937 rng(static_cast<unsigned>(t) + 1);
+			for(int i = 0; i < 1500; ++i)
+				RandomWrite(container, models[static_cast<std::size_t>(t)], rng, t * 1000);
+			--running;
+		});
+	}
+	threads.emplace_back([&container, &running]()
+	{
+		while(running.load() != 0)
+		{
+			auto snapshot = container.GetSnapshot();
+			CHECK(std::is_sorted(snapshot.begin(), snapshot.end()));
+		}
+	});
+	for(std::thread& thread : threads)
+		thread.join();
+
+	std::multiset<int> all;
+	for(std::multiset<int> const& model : models)
+		all.insert(model.begin(), model.end());
+	CHECK(Matches(container, all));
+}
+
+/*!******************************************************************
+  \brief
+    Runs every test under one reclamation policy and every write mode.
+
+  \param name
+	Label to print alongside the results.
+********************************************************************/
+template <typename Reclaimer>
+void RunAll(char const* name)
+{
+	WriteMode const modes[] = { WriteMode::CAS, WriteMode::Combining, WriteMode::Staged };
+	for(WriteMode mode : modes)
+	{
+		EmptyTest<Reclaimer>(mode);
+		ModelTest<Reclaimer>(mode, 1);
+		ModelTest<Reclaimer>(mode, 2);
+		ConcurrentTest<Reclaimer>(mode, 4);
+	}
+	std::printf("%s: done\n", name);
+}
+
+/*!******************************************************************
+  \brief
+    Main function for the Erase family tests.
+
+  \return
+	The # of failed checks.
+********************************************************************/
+int main()
+{
+	RunAll<HazardReclaimer>("hazard");
+	RunAll<EpochReclaimer>("epoch ");
+	RunAll<SharedHazardReclaimer>("shared");
+
+	std::printf("lfsv_erase_test: %d failure(s)\n", Failures().load());
+	return Failures().load() != 0;
+}
@@ -0,0 +1,314 @@
+/******************************************************************************/
+/*!
+\file   lfsv_packed_test.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the unit tests for PackedLFSV's block codec: every
+	delta width from 0 to 32 and run encodings of every width round-trip
+	through EncodeBlock(), DecodeBlock() and BlockAt(), including deltas
+	spanning INT_MIN to INT_MAX and blocks of 1 and 128 values. Inserting
+	a 129th value checks the split path, and the AVX2 prefix sum is
+	checked against the scalar one for lengths that are not a multiple
+	of 8.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_packed_test.cpp -o lfsv_packed_test
+	(or make test / make test-asan / make test-tsan from the parent directory)
+
+*/
+/******************************************************************************/
+
+#include "../lfsv_packed.h"
+#include "check.h"
+#include <set>     // std::multiset
+#include <random>  // std::mt19937
+#include <climits> // INT_MIN, INT_MAX
+#include <cstdio>  // std::printf
+
+/*!******************************************************************
+  \brief
+    Encodes a sorted run of values, then checks the header, a full
+	decode and every single-value lookup against the input.
+
+  \param values
+	The values, sorted.
+
+  \return
+	Whether the block came out run encoded.
+********************************************************************/
+bool RoundTrip(std::vector<int> const& values)
+{
+	CHECK(std::is_sorted(values.begin(), values.end()));
+
+	unsigned n = static_cast<unsigned>(values.size());
+	PackedBlock* block = EncodeBlock(values.data(), n);
+
+	CHECK(block->count == n);
+	CHECK(block->low == values.front());
+	CHECK(block->high == values.back());
+
+	std::vector<int> decoded(n);
+	DecodeBlock(block, decoded.data());
+	CHECK(decoded == values);
+
+	for(unsigned i = 0; i < n; ++i)
+		if(!CHECK(BlockAt(block, i) == values[i]))
+			break;
+
+	bool runs = block->runs != 0;
+	DestroyBlock(block);
+	return runs;
+}
+
+/*!******************************************************************
+  \brief
+    Builds a sorted run of n values, starting at base, whose largest
+	delta takes exactly width bits. The other deltas are random but
+	small enough that the run never passes INT_MAX.
+
+  \param rng
+	The random source.
+
+  \param n
+	The # of values, at least 2.
+
+  \param width
+	The width of the largest delta, from 0 to 32.
+
+  \param base
+	The first value.
+
+  \return
+	The values.
+********************************************************************/
+std::vector<int> DeltaRun(std::mt19937& rng, unsigned n, unsigned width, int base)
+{
+	std::uint64_t widest = width == 0 ? 0 : (std::uint64_t(1) << width) - 1;
+	std::uint64_t room = static_cast<std::uint64_t>(std::int64_t(INT_MAX) - base);
+	std::uint64_t rest = std::min(widest, (room - widest) / (n - 1));
+	unsigned wide = static_cast<unsigned>(rng() % (n - 1));
+
+	std::vector<int> values(1, base);
+	std::int64_t value = base;
+	for(unsigned i = 0; i + 1 < n; ++i)
+	{
+		value += static_cast<std::int64_t>(i == wide ? widest : (rest == 0 ? 0 : rng() % (rest + 1)));
+		values.push_back(static_cast<int>(value));
+	}
+	return values;
+}
+
+/*!******************************************************************
+  \brief
+    Round-trips delta encoded blocks of every width from 0 to 32, at
+	several lengths, starting at INT_MIN, around 0 and as high as each
+	width allows.
+********************************************************************/
+void DeltaWidths()
+{
+	std::mt19937 rng(7);
+	unsigned const lengths[] = { 2, 7, 8, 9, 31, 127, 128 };
+
+	for(unsigned width = 0; width <= 32; ++width)
+	{
+		for(unsigned n : lengths)
+		{
+			std::uint64_t widest = width == 0 ? 0 : (std::uint64_t(1) << width) - 1;
+			int const bases[] = { INT_MIN, -3, static_cast<int>(std::int64_t(INT_MAX) - static_cast<std::int64_t>(widest)) };
+			for(int base : bases)
+			{
+				if(width == 32 && base != INT_MIN)
+					continue;
+
+				std::vector<int> values = DeltaRun(rng, n, width, base);
+				PackedBlock* block = EncodeBlock(values.data(), n);
+				if(block->runs == 0)
+					CHECK(block->width == width);
+				DestroyBlock(block);
+				RoundTrip(values);
+			}
+		}
+	}
+
+	// The widest possible delta, on its own and inside a full block
+	CHECK(!RoundTrip({ INT_MIN, INT_MAX }));
+	std::vector<int> full(127, INT_MIN);
+	full.push_back(INT_MAX);
+	RoundTrip(full);
+}
+
+/*!******************************************************************
+  \brief
+    Round-trips run encoded blocks with run deltas of every width from 1
+	to 32 and runs long enough that run encoding always wins. A 32-bit
+	run delta only fits from INT_MIN to INT_MAX, so that width is two
+	runs. Also covers runs of one and a block that is a single run.
+********************************************************************/
+void RunWidths()
+{
+	std::mt19937 rng(11);
+
+	for(unsigned width = 1; width < 32; ++width)
+	{
+		std::uint64_t widest = (std::uint64_t(1) << width) - 1;
+		std::vector<int> values;
+		std::int64_t value = INT_MIN;
+		bool wide = false;
+		while(values.size() < packedBlock)
+		{
+			unsigned length = std::min<unsigned>(8 + rng() % 9, packedBlock - static_cast<unsigned>(values.size()));
+			values.insert(values.end(), length, static_cast<int>(value));
+
+			// One delta of the full width, the rest one step each
+			value += wide || width == 1 ? 1 : static_cast<std::int64_t>(widest);
+			wide = true;
+		}
+		CHECK(RoundTrip(values));
+	}
+
+	std::vector<int> ends(64, INT_MIN);
+	ends.insert(ends.end(), 64, INT_MAX);
+	CHECK(RoundTrip(ends));
+
+	// Runs of one and runs of the whole block
+	std::vector<int> mixed = { -5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9 };
+	RoundTrip(mixed);
+	RoundTrip(std::vector<int>(packedBlock, 42));
+	RoundTrip(std::vector<int>(packedBlock, INT_MIN));
+}
+
+/*!******************************************************************
+  \brief
+    Round-trips blocks holding a single value.
+********************************************************************/
+void SingleValues()
+{
+	int const values[] = { INT_MIN, -1, 0, 1, INT_MAX };
+	for(int value : values)
+		CHECK(!RoundTrip({ value }));
+}
+
+/*!******************************************************************
+  \brief
+    Checks the container against a model after filling one block to
+	packedBlock values, after a 129th value splits it, and as more
+	values (extremes and duplicates among them) split it further and
+	are erased again.
+********************************************************************/
+void SplitPath()
+{
+	PackedLFSV<> container;
+	std::multiset<int> model;
+
+	auto matches = [&container, &model]()
+	{
+		std::vector<int> values;
+		container.Copy(values);
+		bool same = container.size() == model.size() && values.size() == model.size() &&
+		            std::equal(values.begin(), values.end(), model.begin());
+		std::size_t i = 0;
+		for(auto it = model.begin(); same && it != model.end(); ++it, ++i)
+			same = container[i] == *it;
+		return same;
+	};
+
+	for(int i = 0; i < static_cast<int>(packedBlock); ++i)
+	{
+		container.Insert(i * 3);
+		model.insert(i * 3);
+	}
+	CHECK(matches());
+
+	container.Insert(100);
+	model.insert(100);
+	CHECK(matches());
+
+	std::mt19937 rng(3);
+	int const extremes[] = { INT_MIN, INT_MAX, INT_MIN, INT_MAX, 0, 0 };
+	for(int value : extremes)
+	{
+		container.Insert(value);
+		model.insert(value);
+	}
+	for(int i = 0; i < 1000; ++i)
+	{
+		int value = static_cast<int>(rng() % 500) - 250;
+		container.Insert(value);
+		model.insert(value);
+	}
+	CHECK(matches());
+
+	while(!model.empty())
+	{
+		auto it = model.begin();
+		std::advance(it, static_cast<long>(rng() % model.size()));
+		CHECK(container.Erase(*it));
+		model.erase(it);
+		if(model.size() % 97 == 0 && !CHECK(matches()))
+			return;
+	}
+	CHECK(!container.Erase(0));
+	CHECK(container.size() == 0);
+}
+
+/*!******************************************************************
+  \brief
+    Checks the AVX2 prefix sum against the scalar one for every length
+	up to 40 and a few longer ones, none of them needing to be a
+	multiple of 8, with deltas and bases that wrap around.
+********************************************************************/
+void PrefixSums()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	if(!__builtin_cpu_supports("avx2"))
+	{
+		std::printf("prefix sum: no AVX2, skipped\n");
+		return;
+	}
+
+	std::mt19937 rng(5);
+	std::vector<std::size_t> lengths;
+	for(std::size_t n = 0; n <= 40; ++n)
+		lengths.push_back(n);
+	lengths.push_back(127);
+	lengths.push_back(1001);
+
+	for(std::size_t n : lengths)
+	{
+		std::vector<std::uint32_t> scalar(n);
+		for(std::uint32_t& delta : scalar)
+			delta = static_cast<std::uint32_t>(rng());
+		std::vector<std::uint32_t> simd = scalar;
+
+		std::uint32_t base = static_cast<std::uint32_t>(rng());
+		PrefixSumScalar(scalar.data(), n, base);
+		PrefixSumAvx2(simd.data(), n, base);
+		CHECK(simd == scalar);
+	}
+#endif
+}
+
+/*!******************************************************************
+  \brief
+    Main function for the packed codec tests.
+
+  \return
+	The # of failed checks.
+********************************************************************/
+int main()
+{
+	DeltaWidths();
+	RunWidths();
+	SingleValues();
+	SplitPath();
+	PrefixSums();
+
+	std::printf("lfsv_packed_test: %d failure(s)\n", Failures().load());
+	return Failures().load() != 0;
+}
@@ -0,0 +1,326 @@
+/******************************************************************************/
+/*!
+\file   lfsv_snapshot_test.cpp
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the unit tests for LFSV::SaveSnapshot() and
+	LFSV::LoadSnapshot(): round trips (empty ones included), loads of
+	every truncation and every single-bit flip of a file, files written
+	for another value type, several threads saving to the same path at
+	once, and the permissions a saved file is given. A load that fails
+	must throw and leave the container as it was.
+
+	Build with: g++ -std=c++17 -O2 -pthread lfsv_snapshot_test.cpp -o lfsv_snapshot_test
+	(or make test / make test-asan / make test-tsan from the parent directory)
+
+*/
+/******************************************************************************/
+
+#include "../lfsv.h"
+#include "check.h"
+#include <fstream> // std::ifstream, std::ofstream
+#include <cstdio>  // std::printf, std::remove
+#include <cstdlib> // mkdtemp
+#include <dirent.h> // opendir
+#include <sys/stat.h> // stat, umask
+
+/*!******************************************************************
+  \brief
+    Copies every value out of a container.
+
+  \param container
+	The container to read.
+
+  \return
+	Its values, in order.
+********************************************************************/
+template <typename T>
+std::vector<T> Values(LFSV<T>& container)
+{
+	typename LFSV<T>::Snapshot snapshot = container.GetSnapshot();
+	return std::vector<T>(snapshot.begin(), snapshot.end());
+}
+
+/*!******************************************************************
+  \brief
+    Reads a whole file.
+
+  \param path
+	The file to read.
+
+  \return
+	Its bytes.
+********************************************************************/
+std::string ReadFile(std::string const& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/*!******************************************************************
+  \brief
+    Writes a whole file, replacing anything already there.
+
+  \param path
+	The file to write.
+
+  \param bytes
+	Its new contents.
+********************************************************************/
+void WriteFile(std::string const& path, std::string const& bytes)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/*!******************************************************************
+  \brief
+    Loads a file that must be refused, and checks the container threw
+	std::runtime_error and still holds what it held before.
+
+  \param container
+	The container to load into.
+
+  \param path
+	The file to load.
+
+  \return
+	Whether the load was refused cleanly.
+********************************************************************/
+bool Refused(LFSV<int>& container, std::string const& path)
+{
+	std::vector<int> before = Values(container);
+	bool threw = false;
+	try
+	{
+		container.LoadSnapshot(path.c_str());
+	}
+	catch(std::runtime_error const&)
+	{
+		threw = true;
+	}
+	return threw && Values(container) == before;
+}
+
+/*!******************************************************************
+  \brief
+    Saves and loads containers, empty ones and ones full of duplicates,
+	and checks a load can be written to afterwards.
+
+  \param dir
+	The directory to write files in.
+********************************************************************/
+void RoundTrips(std::string const& dir)
+{
+	std::string path = dir + "/round.snap";
+
+	LFSV<int> empty;
+	empty.SaveSnapshot(path.c_str());
+	LFSV<int> loaded;
+	loaded.Insert(9);
+	loaded.LoadSnapshot(path.c_str());
+	CHECK(Values(loaded).empty());
+
+	LFSV<int> source;
+	for(int i = 0; i < 5000; ++i)
+		source.Insert(i % 37 - 18);
+	source.SaveSnapshot(path.c_str());
+	loaded.LoadSnapshot(path.c_str());
+	CHECK(Values(loaded) == Values(source));
+
+	// The first write copies the values out of the mapping
+	loaded.Insert(-100);
+	source.Insert(-100);
+	CHECK(Values(loaded) == Values(source));
+
+	// Saving over an existing snapshot replaces it whole
+	empty.SaveSnapshot(path.c_str());
+	loaded.LoadSnapshot(path.c_str());
+	CHECK(Values(loaded).empty());
+}
+
+/*!******************************************************************
+  \brief
+    Checks every truncation, every single-bit flip and an appended byte
+	of a good file are all refused, along with missing files, files for
+	another value type and saves to a missing directory.
+
+  \param dir
+	The directory to write files in.
+********************************************************************/
+void CorruptFiles(std::string const& dir)
+{
+	std::string path = dir + "/good.snap";
+	std::string bad = dir + "/bad.snap";
+
+	LFSV<int> source;
+	for(int i = 0; i < 11; ++i)
+		source.Insert(i * 7 - 30);
+	source.SaveSnapshot(path.c_str());
+	std::string good = ReadFile(path);
+	CHECK(good.size() == sizeof(SnapshotHeader) + 11 * sizeof(int));
+
+	LFSV<int> container;
+	container.Insert(1);
+	container.Insert(2);
+
+	for(std::size_t length = 0; length < good.size(); ++length)
+	{
+		WriteFile(bad, good.substr(0, length));
+		if(!CHECK(Refused(container, bad)))
+			std::printf("  truncated to %zu bytes\n", length);
+	}
+
+	for(std::size_t bit = 0; bit < good.size() * 8; ++bit)
+	{
+		std::string flipped = good;
+		flipped[bit / 8] = static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+		WriteFile(bad, flipped);
+		if(!CHECK(Refused(container, bad)))
+			std::printf("  bit %zu flipped\n", bit);
+	}
+
+	WriteFile(bad, good + '\0');
+	CHECK(Refused(container, bad));
+	CHECK(Refused(container, dir + "/missing.snap"));
+
+	// The same bytes read as another value type
+	LFSV<long long> wide;
+	bool threw = false;
+	try
+	{
+		wide.LoadSnapshot(path.c_str());
+	}
+	catch(std::runtime_error const&)
+	{
+		threw = true;
+	}
+	CHECK(threw && Values(wide).empty());
+
+	threw = false;
+	try
+	{
+		source.SaveSnapshot((dir + "/missing/x.snap").c_str());
+	}
+	catch(std::runtime_error const&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+
+	// The good file still loads after all that
+	container.LoadSnapshot(path.c_str());
+	CHECK(Values(container) == Values(source));
+}
+
+/*!******************************************************************
+  \brief
+    Has several threads save different containers to the same path at
+	once, and checks the file left behind is one of them, whole, with no
+	temporary files left over.
+
+  \param dir
+	The directory to write files in.
+********************************************************************/
+void ConcurrentSaves(std::string const& dir)
+{
+	std::string path = dir + "/shared.snap";
+	const int savers = 4;
+
+	std::vector<std::unique_ptr<LFSV<int>>> sources;
+	for(int t = 0; t < savers; ++t)
+	{
+		sources.emplace_back(new LFSV<int>());
+		for(int i = 0; i < 2000 * (t + 1); ++i)
+			sources.back()->Insert(t * 100000 + i);
+	}
+
+	std::vector<std::thread> threads;
+	for(int t = 0; t < savers; ++t)
+	{
+		threads.emplace_back([&sources, &path, t]()
+		{
+			for(int i = 0; i < 20; ++i)
+				sources[static_cast<std::size_t>(t)]->SaveSnapshot(path.c_str());
+		});
+	}
+	for(std::thread& thread : threads)
+		thread.join();
+
+	LFSV<int> loaded;
+	loaded.LoadSnapshot(path.c_str());
+	std::vector<int> values = Values(loaded);
+	bool matched = false;
+	for(auto const& source : sources)
+		matched = matched || values == Values(*source);
+	CHECK(matched);
+
+	int leftovers = 0;
+	DIR* listing = opendir(dir.c_str());
+	for(dirent* entry = readdir(listing); entry != nullptr; entry = readdir(listing))
+		leftovers += std::string(entry->d_name).find("shared.snap.") == 0;
+	closedir(listing);
+	CHECK(leftovers == 0);
+}
+
+/*!******************************************************************
+  \brief
+    Checks a saved file gets the permissions the process's umask allows,
+	as a file made with std::fopen() would, rather than fixed ones.
+
+  \param dir
+	The directory to write files in.
+********************************************************************/
+void Permissions(std::string const& dir)
+{
+	std::string path = dir + "/mode.snap";
+	LFSV<int> source;
+	source.Insert(1);
+
+	mode_t const masks[] = { 077, 022, 0 };
+	mode_t old = umask(0);
+	for(mode_t mask : masks)
+	{
+		umask(mask);
+		source.SaveSnapshot(path.c_str());
+		struct stat info;
+		if(CHECK(stat(path.c_str(), &info) == 0) && !CHECK((info.st_mode & 0777) == (0666 & ~mask)))
+			std::printf("  umask %03o gave mode %03o\n", unsigned(mask), unsigned(info.st_mode & 0777));
+	}
+	umask(old);
+}
+
+/*!******************************************************************
+  \brief
+    Main function for the snapshot file tests.
+
+  \return
+	The # of failed checks.
+********************************************************************/
+int main()
+{
+	char pattern[] = "/tmp/lfsv_snapshot_test.XXXXXX";
+	if(!CHECK(mkdtemp(pattern) != nullptr))
+		return 1;
+	std::string dir = pattern;
+
+	RoundTrips(dir);
+	CorruptFiles(dir);
+	ConcurrentSaves(dir);
+	Permissions(dir);
+
+	char const* names[] = { "round.snap", "good.snap", "bad.snap", "shared.snap", "mode.snap" };
+	for(char const* name : names)
+		std::remove((dir + "/" + name).c_str());
+	std::remove(dir.c_str());
+
+	std::printf("lfsv_snapshot_test: %d failure(s)\n", Failures().load());
+	return Failures().load() != 0;
+}
@@ -0,0 +1,733 @@
+/******************************************************************************/
+/*!
+\file   trace.h
+\author Jack Waldron
+\par    email: jack.waldron\@digipen.edu
+\par    DigiPen login: jack.waldron
+\par    Course: CS355
+\par    Section: A
+\par    Hazard Pointers Project
+\date   10/17/26
+
+\brief
+    This file contains the opt-in per-operation tracing used by the
+	containers and reclamation policies. Each thread records timestamped
+	events into its own fixed-size ring, with no locks and no allocation
+	once its ring exists. The rings can be dumped at any time, even while
+	threads keep recording, as a Chrome trace (chrome://tracing or
+	Perfetto) or as HDR-style latency histograms per operation.
+
+*/
+/******************************************************************************/
+
+#pragma once
+#include <atomic>    // std::atomic
+#include <chrono>    // std::chrono::steady_clock
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <cstddef>   // std::ptrdiff_t
+#include <vector>    // std::vector
+#include <ostream>   // std::ostream
+#include <iomanip>   // std::setw, std::setprecision
+#include <cmath>     // std::pow, std::sqrt
+#include <algorithm> // std::min, std::max
+
+/*!******************************************************************
+  \brief
+    Tracing is opt-in: build with LFSV_TRACING defined to record events.
+	Without it, every LFSV_TRACE() statement compiles to nothing and the
+	dumps come out empty.
+********************************************************************/
+#ifdef LFSV_TRACING
+#define LFSV_TRACE(statement) statement
+#else
+#define LFSV_TRACE(statement)
+#endif
+
+/*!
+  \brief
+    The points an operation can be traced at. Each begin is closed by
+	the matching end (an insert or a merge by its commit). A merge is
+	the one CAS publishing a sorted run for InsertBatch(), a combiner or
+	a flush of staged values; under combining or staging it may run
+	inside an insert, or on a thread that never began one.
+*/
+enum class TraceEvent : std::uint8_t
+{
+	InsertBegin, // An insert has started
+	CasAttempt,  // A publish attempt is about to CAS; arg is the attempt #
+	CasCommit,   // An insert has been published; arg is the # of attempts
+	ScanBegin,   // A scan (or epoch collect) of a retired list has started
+	ScanEnd,     // The scan is done; arg is the # of pointers it reclaimed
+	ReadBegin,   // An indexed read has started
+	ReadEnd,     // The indexed read is done
+	MergeBegin,  // A sorted run is being merged in; arg is its # of values
+	MergeCommit  // The merged run has been published; arg is the # of attempts
+};
+
+const unsigned traceEvents = 9; // # of TraceEvent values
+
+const unsigned traceCapacity = 1 << 14; // # of events kept by each thread's ring
+
+/**************************************************************************/
+/*!
+  \class LatencyHistogram
+  \brief
+    A log-linear histogram of latencies in ns, in the style of
+	HdrHistogram. Values below 128 are counted exactly; above that, each
+	power of two is split into 64 buckets, so any recorded value is off
+	by under 1.6%, from 1 ns up to the full 64-bit range.
+
+    Non-Core Operations Include:
+
+    -Returns the # of values recorded.
+	-Returns the largest value recorded.
+	-Returns the value at a percentile.
+	-Writes the percentile distribution in HdrHistogram's text format.
+
+*/
+/**************************************************************************/
+class LatencyHistogram
+{
+	static const unsigned subBits = 7;                      // log2 of the # of exact values
+	static const unsigned subCount = 1u << subBits;         // Values counted exactly
+	static const unsigned halfCount = subCount / 2;         // Buckets per power of two above that
+	static const unsigned bucketCount = subCount + (64 - subBits + 1) * halfCount;
+
+	std::vector<std::uint64_t> counts; // # of values per bucket
+	std::uint64_t total;               // # of values recorded
+	std::uint64_t max;                 // Largest value recorded
+	double sum;                        // Sum of every value, for the mean
+	double squares;                    // Sum of every value squared, for the deviation
+
+	/*!******************************************************************
+      \brief
+        Returns the bucket a value is counted in.
+
+	  \param value
+	  	The value to look up.
+
+	  \return
+	  	The bucket's index.
+    ********************************************************************/
+	static unsigned Bucket(std::uint64_t value)
+	{
+		if(value < subCount)
+			return static_cast<unsigned>(value);
+
+		unsigned shift = 63 - static_cast<unsigned>(__builtin_clzll(value)) - (subBits - 1);
+		return subCount + (shift - 1) * halfCount + static_cast<unsigned>((value >> shift) - halfCount);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the largest value counted in a bucket.
+
+	  \param bucket
+	  	The bucket's index.
+
+	  \return
+	  	The bucket's upper bound.
+    ********************************************************************/
+	static std::uint64_t Highest(unsigned bucket)
+	{
+		if(bucket < subCount)
+			return bucket;
+
+		unsigned shift = (bucket - subCount) / halfCount + 1;
+		std::uint64_t low = static_cast<std::uint64_t>((bucket - subCount) % halfCount + halfCount) << shift;
+		return low + ((std::uint64_t(1) << shift) - 1);
+	}
+
+	public:
+
+	/*!******************************************************************
+      \brief
+        Constructor for the LatencyHistogram class.
+    ********************************************************************/
+	LatencyHistogram() : counts(std::size_t(bucketCount), 0), total(0), max(0), sum(0.0), squares(0.0)
+	{}
+
+	/*!******************************************************************
+      \brief
+        Records one value.
+
+	  \param value
+	  	The latency to record, in ns.
+    ********************************************************************/
+	void Add(std::uint64_t value)
+	{
+		++counts[Bucket(value)];
+		++total;
+		if(value > max)
+			max = value;
+		sum += static_cast<double>(value);
+		squares += static_cast<double>(value) * static_cast<double>(value);
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the # of values recorded.
+
+	  \return
+	  	The # of values recorded.
+    ********************************************************************/
+	std::uint64_t Count() const
+	{
+		return total;
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the largest value recorded.
+
+	  \return
+	  	The largest value recorded, in ns.
+    ********************************************************************/
+	std::uint64_t Max() const
+	{
+		return max;
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the value at a percentile: the largest value that the
+		given fraction of recorded values are no greater than.
+
+	  \param p
+	  	The percentile, from 0 to 100.
+
+	  \return
+	  	The value at the percentile, in ns; 0 if nothing is recorded.
+    ********************************************************************/
+	std::uint64_t ValueAt(double p) const
+	{
+		if(total == 0)
+			return 0;
+
+		std::uint64_t wanted = static_cast<std::uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total)));
+		if(wanted == 0)
+			wanted = 1;
+
+		std::uint64_t seen = 0;
+		for(unsigned i = 0; i < bucketCount; ++i)
+		{
+			seen += counts[i];
+			if(seen >= wanted)
+				return std::min(Highest(i), max);
+		}
+		return max;
+	}
+
+	/*!******************************************************************
+      \brief
+        Writes the percentile distribution in HdrHistogram's text
+		format, which its plotting tools read directly. Percentiles
+		are spaced five to every halving of the distance to 100%.
+
+	  \param out
+	  	The stream to write to.
+    ********************************************************************/
+	void Write(std::ostream& out) const
+	{
+		std::ios::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+
+		std::uint64_t seen = 0;
+		unsigned bucket = 0;
+		for(unsigned step = 0; total != 0; ++step)
+		{
+			double fraction = 1.0 - std::pow(0.5, step / 5.0);
+			std::uint64_t wanted = std::max<std::uint64_t>(1,
+				static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+
+			for(; bucket < bucketCount && seen + counts[bucket] < wanted; ++bucket)
+				seen += counts[bucket];
+			std::uint64_t reached = seen + (bucket < bucketCount ? counts[bucket] : 0);
+			double percentile = static_cast<double>(reached) / static_cast<double>(total);
+
+			out << std::fixed << std::setprecision(3) << std::setw(12)
+			    << static_cast<double>(std::min(Highest(bucket), max))
+			    << std::setprecision(12) << std::setw(15) << percentile
+			    << std::setw(11) << reached;
+			if(reached < total)
+				out << std::setprecision(2) << std::setw(15) << 1.0 / (1.0 - percentile);
+			out << '\n';
+
+			if(reached == total)
+				break;
+		}
+
+		double mean = total ? sum / static_cast<double>(total) : 0.0;
+		double deviation = total ? std::sqrt(std::max(0.0, squares / static_cast<double>(total) - mean * mean)) : 0.0;
+		out << std::setprecision(3)
+		    << "#[Mean    = " << std::setw(12) << mean << ", StdDeviation   = " << std::setw(12) << deviation << "]\n"
+		    << "#[Max     = " << std::setw(12) << static_cast<double>(max)
+		    << ", Total count    = " << std::setw(12) << total << "]\n"
+		    << "#[Buckets = " << std::setw(12) << bucketCount - subCount
+		    << ", SubBuckets     = " << std::setw(12) << subCount << "]\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+};
+
+/**************************************************************************/
+/*!
+  \class Tracer
+  \brief
+    The process-wide set of per-thread event rings. A thread claims a
+	ring the first time it records, and hands it back when it exits for
+	the next new thread to reuse. Only the owning thread ever writes to
+	a ring; a dump copies each ring out and keeps only the events that
+	were not overwritten while it was copying, so recording never waits
+	on a dump.
+
+    Non-Core Operations Include:
+
+    -Records an event on the calling thread's ring.
+	-Builds a latency histogram per operation from every ring.
+	-Writes every ring as a Chrome trace.
+	-Writes every operation's latency histogram.
+
+*/
+/**************************************************************************/
+class Tracer
+{
+	/*!
+	  \struct Slot
+	  \brief
+	    One recorded event. Atomic so that a dump may read it while the
+	    owner overwrites it; a dump throws away any slot it could have
+	    seen half-written.
+	*/
+	struct Slot
+	{
+		std::atomic<std::uint64_t> nanos{0}; // When the event happened, since the tracer started
+		std::atomic<std::uint64_t> word{0};  // Event, thread and argument, packed
+	};
+
+	/*!
+	  \struct Ring
+	  \brief
+	    One thread's events, oldest overwritten first.
+	*/
+	struct Ring
+	{
+		std::atomic<std::uint64_t> begun{0}; // # of events whose write has started
+		std::atomic<std::uint64_t> ended{0}; // # of events whose write has finished
+		std::atomic<bool> active{false};     // Whether a thread currently owns this ring
+		std::uint32_t thread = 0;            // Trace id of the owning thread; owner only
+		Ring* next = nullptr;                // Pointer to the next ring in the list
+		Slot slots[traceCapacity];           // The events themselves
+	};
+
+	/*!
+	  \struct Event
+	  \brief
+	    An event copied out of a ring by a dump.
+	*/
+	struct Event
+	{
+		std::uint64_t nanos;  // When the event happened, since the tracer started
+		TraceEvent event;     // What happened
+		std::uint32_t thread; // Trace id of the thread it happened on
+		std::uint32_t arg;    // The event's argument
+	};
+
+	/*!
+	  \struct Owner
+	  \brief
+	    Hands the calling thread's ring back when the thread exits.
+	*/
+	struct Owner
+	{
+		~Owner()
+		{
+			Ring*& ring = Local();
+			if(ring)
+				ring->active.store(false);
+			ring = nullptr;
+			Exited() = true;
+		}
+	};
+
+	std::atomic<Ring*> rings;              // Every ring ever created
+	std::atomic<std::uint32_t> threads;    // Source of per-thread trace ids
+	std::chrono::steady_clock::time_point origin; // Time 0 of every event
+
+	/*!******************************************************************
+      \brief
+        Constructor for the Tracer class.
+    ********************************************************************/
+	Tracer() : rings(nullptr), threads(0), origin(std::chrono::steady_clock::now())
+	{}
+
+	/*!******************************************************************
+      \brief
+        Returns the calling thread's ring, if it has one.
+
+	  \return
+	  	A reference to the calling thread's ring pointer.
+    ********************************************************************/
+	static Ring*& Local()
+	{
+		static thread_local Ring* ring = nullptr;
+		return ring;
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns whether the calling thread has already handed its ring
+		back, so events recorded while it exits are dropped.
+
+	  \return
+	  	A reference to the calling thread's exit flag.
+    ********************************************************************/
+	static bool& Exited()
+	{
+		static thread_local bool exited = false;
+		return exited;
+	}
+
+	/*!******************************************************************
+      \brief
+        Claims a ring for the calling thread, reusing one left behind by
+		an exited thread if there is one.
+
+	  \return
+	  	The claimed ring.
+    ********************************************************************/
+	Ring* Claim()
+	{
+		Ring* ring = rings.load();
+		for(; ring != nullptr; ring = ring->next)
+		{
+			bool f = false;
+			if(!ring->active.load() && ring->active.compare_exchange_strong(f, true))
+				break;
+		}
+
+		if(ring == nullptr)
+		{
+			ring = new Ring();
+			ring->active.store(true);
+
+			Ring* oldRing = nullptr;
+			do
+			{
+				oldRing = rings.load();
+				ring->next = oldRing;
+			} while (!rings.compare_exchange_weak(oldRing, ring));
+		}
+
+		ring->thread = threads.fetch_add(1) + 1;
+		return ring;
+	}
+
+	/*!******************************************************************
+      \brief
+        Copies every event still held by a ring. Reads the finished
+		count first and the started count last, so any slot that could
+		have been overwritten during the copy is known and skipped.
+
+	  \param ring
+	  	The ring to copy.
+
+	  \param events
+	  	The list to append the events to.
+    ********************************************************************/
+	static void Read(Ring const* ring, std::vector<Event>& events)
+	{
+		std::uint64_t ended = ring->ended.load(std::memory_order_acquire);
+		std::uint64_t first = ended > traceCapacity ? ended - traceCapacity : 0;
+
+		std::vector<Event> copied;
+		copied.reserve(static_cast<std::size_t>(ended - first));
+		for(std::uint64_t i = first; i < ended; ++i)
+		{
+			Slot const& slot = ring->slots[i % traceCapacity];
+			std::uint64_t word = slot.word.load(std::memory_order_relaxed);
+			Event event;
+			event.nanos = slot.nanos.load(std::memory_order_relaxed);
+			event.event = static_cast<TraceEvent>(word >> 56);
+			event.thread = static_cast<std::uint32_t>(word >> 32) & 0xFFFFFF;
+			event.arg = static_cast<std::uint32_t>(word);
+			copied.push_back(event);
+		}
+
+		// Slot i is only rewritten by event i + capacity, which starts after it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		std::uint64_t begun = ring->begun.load(std::memory_order_relaxed);
+		std::uint64_t safe = begun > traceCapacity ? begun - traceCapacity : 0;
+		if(safe > first)
+			copied.erase(copied.begin(), copied.begin() + static_cast<std::ptrdiff_t>(std::min(safe, ended) - first));
+
+		events.insert(events.end(), copied.begin(), copied.end());
+	}
+
+	/*!******************************************************************
+      \brief
+        Returns the begin event an event closes.
+
+	  \param event
+	  	The event to look up.
+
+	  \return
+	  	The begin it closes, or the event itself if it closes nothing.
+    ********************************************************************/
+	static TraceEvent Opener(TraceEvent event)
+	{
+		switch(event)
+		{
+			case TraceEvent::CasCommit:   return TraceEvent::InsertBegin;
+			case TraceEvent::ScanEnd:     return TraceEvent::ScanBegin;
+			case TraceEvent::ReadEnd:     return TraceEvent::ReadBegin;
+			case TraceEvent::MergeCommit: return TraceEvent::MergeBegin;
+			default:                      return event;
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Copies every event held by every ring.
+
+	  \return
+	  	The events, grouped by ring and in order within each.
+    ********************************************************************/
+	std::vector<Event> ReadAll() const
+	{
+		std::vector<Event> events;
+		for(Ring const* ring = rings.load(); ring != nullptr; ring = ring->next)
+			Read(ring, events);
+		return events;
+	}
+
+	public:
+
+	Tracer(Tracer const&) = delete;
+	Tracer& operator=(Tracer const&) = delete;
+
+	/*!******************************************************************
+      \brief
+        Returns the process-wide tracer. Never destroyed, so threads may
+		record events right up until the process exits.
+
+	  \return
+	  	The tracer.
+    ********************************************************************/
+	static Tracer& Global()
+	{
+		static Tracer* tracer = new Tracer();
+		return *tracer;
+	}
+
+	/*!******************************************************************
+      \brief
+        Records an event on the calling thread's ring, overwriting the
+		oldest event once the ring is full.
+
+	  \param event
+	  	What happened.
+
+	  \param arg
+	  	The event's argument; kept to 32 bits.
+    ********************************************************************/
+	void Record(TraceEvent event, std::uint64_t arg = 0)
+	{
+		Ring* ring = Local();
+		if(ring == nullptr)
+		{
+			if(Exited())
+				return;
+
+			static thread_local Owner owner;
+			(void)owner;
+			ring = Local() = Claim();
+		}
+
+		std::uint64_t nanos = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - origin).count());
+		std::uint64_t word = static_cast<std::uint64_t>(event) << 56 |
+		                     static_cast<std::uint64_t>(ring->thread & 0xFFFFFF) << 32 |
+		                     (arg > 0xFFFFFFFF ? 0xFFFFFFFF : arg);
+
+		std::uint64_t index = ring->ended.load(std::memory_order_relaxed);
+		ring->begun.store(index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Slot& slot = ring->slots[index % traceCapacity];
+		slot.nanos.store(nanos, std::memory_order_relaxed);
+		slot.word.store(word, std::memory_order_relaxed);
+		ring->ended.store(index + 1, std::memory_order_release);
+	}
+
+	/*!******************************************************************
+      \brief
+        Builds a latency histogram per operation, by pairing each begin
+		with the next end on the same thread. Operations whose begin has
+		already been overwritten are left out.
+
+	  \param inserts
+	  	Filled with insert latencies, from begin to commit.
+
+	  \param scans
+	  	Filled with scan latencies.
+
+	  \param reads
+	  	Filled with indexed read latencies.
+
+	  \param merges
+	  	Filled with merge latencies, from begin to commit.
+    ********************************************************************/
+	void Histograms(LatencyHistogram& inserts, LatencyHistogram& scans, LatencyHistogram& reads,
+	                LatencyHistogram& merges) const
+	{
+		std::vector<Event> events = ReadAll();
+
+		std::uint32_t thread = 0;  // Thread whose events are being paired
+		std::uint64_t insert = 0;  // Start of the open insert, plus one; 0 if none
+		std::uint64_t scan = 0;    // Start of the open scan, plus one; 0 if none
+		std::uint64_t read = 0;    // Start of the open read, plus one; 0 if none
+		std::uint64_t merge = 0;   // Start of the open merge, plus one; 0 if none
+		for(Event const& e : events)
+		{
+			if(e.thread != thread)
+			{
+				thread = e.thread;
+				insert = scan = read = merge = 0;
+			}
+
+			switch(e.event)
+			{
+				case TraceEvent::InsertBegin: insert = e.nanos + 1; break;
+				case TraceEvent::ScanBegin:   scan = e.nanos + 1;   break;
+				case TraceEvent::ReadBegin:   read = e.nanos + 1;   break;
+				case TraceEvent::MergeBegin:  merge = e.nanos + 1;  break;
+				case TraceEvent::CasCommit:
+					if(insert)
+						inserts.Add(e.nanos + 1 - insert);
+					insert = 0;
+					break;
+				case TraceEvent::ScanEnd:
+					if(scan)
+						scans.Add(e.nanos + 1 - scan);
+					scan = 0;
+					break;
+				case TraceEvent::ReadEnd:
+					if(read)
+						reads.Add(e.nanos + 1 - read);
+					read = 0;
+					break;
+				case TraceEvent::MergeCommit:
+					if(merge)
+						merges.Add(e.nanos + 1 - merge);
+					merge = 0;
+					break;
+				case TraceEvent::CasAttempt:
+					break;
+			}
+		}
+	}
+
+	/*!******************************************************************
+      \brief
+        Writes every event as a Chrome trace: inserts, merges, scans and
+		reads as slices on their thread's track, and each CAS attempt as
+		an instant within its insert or merge, so a slow insert can be
+		lined up against the scans running beside it. An end whose begin
+		has already been overwritten is left out, so it cannot close some
+		other slice.
+
+	  \param out
+	  	The stream to write the JSON to.
+    ********************************************************************/
+	void WriteChromeTrace(std::ostream& out) const
+	{
+		static char const* const names[] = { "Insert", "CAS", "Insert", "Scan", "Scan", "Read", "Read", "Merge", "Merge" };
+		static char const* const phases[] = { "B", "i", "E", "B", "E", "B", "E", "B", "E" };
+
+		std::vector<Event> events = ReadAll();
+
+		out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool first = true;
+		std::uint32_t thread = 0;             // Thread whose events are being written
+		std::uint64_t open[traceEvents] = {}; // # of begins still open, per begin event
+		for(Event const& e : events)
+		{
+			if(e.thread != thread)
+			{
+				thread = e.thread;
+				std::fill(open, open + traceEvents, 0);
+			}
+
+			unsigned kind = static_cast<unsigned>(e.event);
+			unsigned opener = static_cast<unsigned>(Opener(e.event));
+			if(phases[kind][0] == 'B')
+				++open[kind];
+			else if(phases[kind][0] == 'E')
+			{
+				if(open[opener] == 0)
+					continue;
+				--open[opener];
+			}
+
+			out << (first ? "\n" : ",\n") << "{\"name\":\"" << names[kind] << "\",\"ph\":\"" << phases[kind]
+			    << "\",\"pid\":1,\"tid\":" << e.thread << ",\"ts\":" << e.nanos / 1000 << '.'
+			    << std::setfill('0') << std::setw(3) << e.nanos % 1000 << std::setfill(' ');
+
+			if(e.event == TraceEvent::CasAttempt)
+				out << ",\"s\":\"t\",\"args\":{\"attempt\":" << e.arg << '}';
+			else if(e.event == TraceEvent::CasCommit || e.event == TraceEvent::MergeCommit)
+				out << ",\"args\":{\"attempts\":" << e.arg << '}';
+			else if(e.event == TraceEvent::MergeBegin)
+				out << ",\"args\":{\"values\":" << e.arg << '}';
+			else if(e.event == TraceEvent::ScanEnd)
+				out << ",\"args\":{\"reclaimed\":" << e.arg << '}';
+			out << '}';
+			first = false;
+		}
+		out << "\n]}\n";
+	}
+
+	/*!******************************************************************
+      \brief
+        Writes the latency histogram of every operation, each headed by
+		a comment line naming it and giving its p50, p99, p99.9 and max.
+
+	  \param out
+	  	The stream to write the histograms to.
+    ********************************************************************/
+	void WriteHistograms(std::ostream& out) const
+	{
+		LatencyHistogram inserts, scans, reads, merges;
+		Histograms(inserts, scans, reads, merges);
+
+		LatencyHistogram const* histograms[] = { &inserts, &merges, &scans, &reads };
+		char const* names[] = { "Insert", "Merge", "Scan", "Read" };
+		for(unsigned i = 0; i < 4; ++i)
+		{
+			LatencyHistogram const& h = *histograms[i];
+			out << "# " << names[i] << " latency (ns): count " << h.Count()
+			    << ", p50 " << h.ValueAt(50.0) << ", p99 " << h.ValueAt(99.0)
+			    << ", p99.9 " << h.ValueAt(99.9) << ", max " << h.Max() << '\n';
+			h.Write(out);
+			out << '\n';
+		}
+	}
+};
+
+/*!******************************************************************
+  \brief
+    Records an event on the calling thread's ring. Wrap calls in
+	LFSV_TRACE() so they compile away unless tracing is enabled.
+
+  \param event
+	What happened.
+
+  \param arg
+	The event's argument.
+********************************************************************/
+inline void Trace(TraceEvent event, std::uint64_t arg = 0)
+{
+	Tracer::Global().Record(event, arg);
+}